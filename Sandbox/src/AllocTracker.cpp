@@ -0,0 +1,141 @@
+#include "AllocTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if TLE_TRACK_ALLOCATIONS
+    #if defined(__APPLE__)
+        #include <malloc/malloc.h>   // malloc_size
+    #else
+        #include <malloc.h>          // _msize / malloc_usable_size
+    #endif
+#endif
+
+namespace AllocTracker {
+
+    static constexpr size_t k_TagCount = (size_t)AllocTag::Count;
+
+    static const char* const k_TagNames[k_TagCount] = {
+        "Untagged", "Chunks", "Flow Field", "Crowd", "Audio", "Scene"
+    };
+
+    // Written from any thread with relaxed atomics; EndFrame latches them on the main thread.
+    struct Counters {
+        std::atomic<uint64_t> Allocs { 0 };
+        std::atomic<uint64_t> Bytes  { 0 };
+    };
+
+    static Counters              s_Current[k_TagCount];
+    static std::atomic<uint64_t> s_Frees     { 0 };
+    static std::atomic<int64_t>  s_LiveBytes { 0 };
+    static Stats                 s_LastFrame[k_TagCount];
+    static uint64_t              s_LastFrameAllocs = 0;
+    static uint64_t              s_LastFrameFrees  = 0;
+    static uint64_t s_Budgets[k_TagCount] = {
+        64 * 1024,    // Untagged
+        64 * 1024,    // Chunks
+        256 * 1024,   // Flow Field
+        16 * 1024,    // Crowd
+        4 * 1024,     // Audio
+        64 * 1024,    // Scene
+    };
+
+    static thread_local AllocTag t_Tag = AllocTag::Untagged;
+
+    bool IsActive()
+    {
+#if TLE_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    const char* GetTagName(AllocTag tag)
+    {
+        return k_TagNames[(size_t)tag];
+    }
+
+    AllocTag SetTag(AllocTag tag)
+    {
+        AllocTag previous = t_Tag;
+        t_Tag = tag;
+        return previous;
+    }
+
+    void EndFrame()
+    {
+        s_LastFrameAllocs = 0;
+        for (size_t i = 0; i < k_TagCount; i++)
+        {
+            s_LastFrame[i].Allocs = s_Current[i].Allocs.exchange(0, std::memory_order_relaxed);
+            s_LastFrame[i].Bytes  = s_Current[i].Bytes.exchange(0, std::memory_order_relaxed);
+            s_LastFrameAllocs    += s_LastFrame[i].Allocs;
+        }
+        s_LastFrameFrees = s_Frees.exchange(0, std::memory_order_relaxed);
+    }
+
+    const Stats& GetFrameStats(AllocTag tag)       { return s_LastFrame[(size_t)tag]; }
+    uint64_t     GetFrameAllocs()                  { return s_LastFrameAllocs; }
+    uint64_t     GetFrameFrees()                   { return s_LastFrameFrees; }
+    int64_t      GetLiveBytes()                    { return s_LiveBytes.load(std::memory_order_relaxed); }
+    void         SetBudget(AllocTag tag, uint64_t b) { s_Budgets[(size_t)tag] = b; }
+    uint64_t     GetBudget(AllocTag tag)           { return s_Budgets[(size_t)tag]; }
+    bool         IsOverBudget(AllocTag tag)        { return s_LastFrame[(size_t)tag].Bytes > s_Budgets[(size_t)tag]; }
+
+#if TLE_TRACK_ALLOCATIONS
+    static size_t UsableSize(void* ptr)
+    {
+    #if defined(_WIN32)
+        return _msize(ptr);
+    #elif defined(__APPLE__)
+        return malloc_size(ptr);
+    #else
+        return malloc_usable_size(ptr);
+    #endif
+    }
+
+    static void* Allocate(std::size_t size) noexcept
+    {
+        void* ptr = std::malloc(size ? size : 1);
+        if (!ptr) return nullptr;
+
+        const size_t tag = (size_t)t_Tag;
+        s_Current[tag].Allocs.fetch_add(1, std::memory_order_relaxed);
+        s_Current[tag].Bytes.fetch_add(size, std::memory_order_relaxed);
+        s_LiveBytes.fetch_add((int64_t)UsableSize(ptr), std::memory_order_relaxed);
+        return ptr;
+    }
+
+    static void Release(void* ptr) noexcept
+    {
+        if (!ptr) return;
+        s_Frees.fetch_add(1, std::memory_order_relaxed);
+        s_LiveBytes.fetch_sub((int64_t)UsableSize(ptr), std::memory_order_relaxed);
+        std::free(ptr);
+    }
+#endif
+}
+
+#if TLE_TRACK_ALLOCATIONS
+// Over-aligned new/delete are left to the runtime; they are rare here and pair with each other.
+void* operator new(std::size_t size)
+{
+    if (void* p = AllocTracker::Allocate(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size)
+{
+    if (void* p = AllocTracker::Allocate(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept   { return AllocTracker::Allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return AllocTracker::Allocate(size); }
+
+void operator delete(void* ptr) noexcept                                { AllocTracker::Release(ptr); }
+void operator delete[](void* ptr) noexcept                              { AllocTracker::Release(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept                   { AllocTracker::Release(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept                 { AllocTracker::Release(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept         { AllocTracker::Release(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept       { AllocTracker::Release(ptr); }
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+
+// --- ALLOCATION TRACKER ---
+// Counts heap allocations per gameplay subsystem and per frame. Code tags its
+// allocations with ALLOC_SCOPE(tag), a thread-local tag that nests like a
+// profiler zone. Counting replaces the global operator new/delete, so it is a
+// build switch: TLE_TRACK_ALLOCATIONS defaults to 1 in debug builds and to 0
+// when NDEBUG is set, and -DTLE_TRACK_ALLOCATIONS=0/1 overrides it. At 0 the
+// scopes still compile, but nothing is counted and IsActive() returns false.
+// Blocks carry no header, so memory allocated by the engine can still be freed
+// here and the other way round. That is why frees and live bytes are only
+// counted as totals, not per tag.
+
+#ifndef TLE_TRACK_ALLOCATIONS
+    #ifdef NDEBUG
+        #define TLE_TRACK_ALLOCATIONS 0
+    #else
+        #define TLE_TRACK_ALLOCATIONS 1
+    #endif
+#endif
+
+enum class AllocTag : uint8_t {
+    Untagged,
+    Chunks,
+    FlowField,
+    Crowd,
+    Audio,
+    Scene,
+    Count
+};
+
+namespace AllocTracker {
+
+    struct Stats {
+        uint64_t Allocs = 0;
+        uint64_t Bytes  = 0;
+    };
+
+    bool        IsActive();
+    const char* GetTagName(AllocTag tag);
+
+    AllocTag SetTag(AllocTag tag);   // returns the previous tag of this thread
+    void     EndFrame();             // latch this frame's counts and start the next frame
+
+    // All figures are for the last completed frame, except live bytes.
+    const Stats& GetFrameStats(AllocTag tag);
+    uint64_t     GetFrameAllocs();
+    uint64_t     GetFrameFrees();
+    int64_t      GetLiveBytes();
+
+    void     SetBudget(AllocTag tag, uint64_t bytesPerFrame);
+    uint64_t GetBudget(AllocTag tag);
+    bool     IsOverBudget(AllocTag tag);
+
+    class Scope
+    {
+    public:
+        explicit Scope(AllocTag tag) : m_Previous(SetTag(tag)) {}
+        ~Scope() { SetTag(m_Previous); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        AllocTag m_Previous;
+    };
+}
+
+#define ALLOC_SCOPE_CONCAT_IMPL(a, b) a##b
+#define ALLOC_SCOPE_CONCAT(a, b)      ALLOC_SCOPE_CONCAT_IMPL(a, b)
+#define ALLOC_SCOPE(tag)              ::AllocTracker::Scope ALLOC_SCOPE_CONCAT(allocScope_, __LINE__)(tag)
@@ -0,0 +1,12 @@
+#include "ChunkStreaming.h"
+
+void GatherChunksInRange(int centerX, int centerZ, int renderDistance, FrameVector<ChunkCoord>& keep)
+{
+    const int diameter = 2 * renderDistance + 1;
+    keep.clear();
+    keep.reserve((size_t)diameter * diameter);
+
+    for (int x = -renderDistance; x <= renderDistance; ++x)
+        for (int z = -renderDistance; z <= renderDistance; ++z)
+            keep.push_back({ centerX + x, centerZ + z });
+}
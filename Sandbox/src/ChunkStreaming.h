@@ -0,0 +1,29 @@
+#pragma once
+#include "FrameArena.h"
+#include <algorithm>
+#include <utility>
+
+// --- CHUNK STREAMING ---
+// Which map chunks to keep around the player and which to drop. Both lists
+// live in the frame arena; creating and destroying the chunks themselves is
+// left to MainGameLayer.
+
+using ChunkCoord = std::pair<int, int>;
+
+// Every chunk within renderDistance of (centerX, centerZ), filled in (x, z)
+// order so keep is sorted for IsChunkKept.
+void GatherChunksInRange(int centerX, int centerZ, int renderDistance, FrameVector<ChunkCoord>& keep);
+
+inline bool IsChunkKept(const FrameVector<ChunkCoord>& keep, const ChunkCoord& coord)
+{
+    return std::binary_search(keep.begin(), keep.end(), coord);
+}
+
+// Appends every key of active (a map keyed by ChunkCoord) that is not in keep.
+template<typename ChunkMap>
+void GatherChunksOutOfRange(const ChunkMap& active, const FrameVector<ChunkCoord>& keep,
+                            FrameVector<ChunkCoord>& unload)
+{
+    for (const auto& entry : active)
+        if (!IsChunkKept(keep, entry.first)) unload.push_back(entry.first);
+}
@@ -0,0 +1,87 @@
+#include "CrowdAudio.h"
+#include <algorithm>
+#include <cmath>
+
+void CrowdAudio::Init(Aether::UUID groanSoundID, VoicePool& pool)
+{
+    m_Pool         = &pool;
+    m_GroanSoundID = groanSoundID;
+    m_Pool->Reserve(m_GroanSoundID, m_Settings.MaxVoices, -1,   // lowest priority: any SFX may steal these
+                    Aether::AudioType::Audio3D);
+
+    Aether::AudioSystem::CreateSource(m_AmbienceSrcID, m_GroanSoundID, Aether::AudioType::Audio2D);
+    Aether::AudioSystem::SetLooping(m_AmbienceSrcID, true);
+    Aether::AudioSystem::SetVolume(m_AmbienceSrcID, 0.0f);
+    Aether::AudioSystem::Play(m_AmbienceSrcID);
+    m_AmbienceVolume = 0.0f;
+}
+
+void CrowdAudio::Shutdown()
+{
+    if (m_AmbienceSrcID != 0) {
+        Aether::AudioSystem::Stop(m_AmbienceSrcID);
+        Aether::AudioSystem::DestroySource(m_AmbienceSrcID);
+    }
+    if (m_Pool) m_Pool->Release(m_GroanSoundID);
+
+    m_AmbienceSrcID  = 0;
+    m_Pool           = nullptr;
+    m_GroanTimer     = 0.0f;
+    m_AmbienceVolume = 0.0f;
+    m_Candidates.clear();
+}
+
+uint32_t CrowdAudio::Select(const glm::vec3& listenerPos, const std::vector<glm::vec3>& emitters)
+{
+    const float maxDistSq = m_Settings.MaxDistance * m_Settings.MaxDistance;
+    const float invRefSq  = 1.0f / (m_Settings.RefDistance * m_Settings.RefDistance);
+
+    // Distance cull on squared distance, inverse-square style falloff for the rest.
+    m_Candidates.clear();
+    for (uint32_t i = 0; i < (uint32_t)emitters.size(); i++)
+    {
+        glm::vec3 d      = emitters[i] - listenerPos;
+        float     distSq = glm::dot(d, d);
+        if (distSq > maxDistSq) continue;
+        m_Candidates.push_back({ 1.0f / (1.0f + distSq * invRefSq), i });
+    }
+    m_AudibleCount = (uint32_t)m_Candidates.size();
+
+    uint32_t voiced = std::min(m_Settings.MaxVoices, m_AudibleCount);
+    if (voiced < m_AudibleCount)
+        std::nth_element(m_Candidates.begin(), m_Candidates.begin() + voiced, m_Candidates.end(),
+                         [](const Candidate& a, const Candidate& b) { return a.gain > b.gain; });
+    return voiced;
+}
+
+void CrowdAudio::Update(float ts, const glm::vec3& listenerPos, const std::vector<glm::vec3>& emitters)
+{
+    if (!m_Pool) return;
+
+    const uint32_t voiced = Select(listenerPos, emitters);
+
+    // Everything outside the top-N is folded into the ambience loop.
+    float restGain = 0.0f;
+    for (uint32_t i = voiced; i < m_AudibleCount; i++)
+        restGain += m_Candidates[i].gain;
+
+    float ambience = std::min(restGain * m_Settings.AmbienceGain, m_Settings.MaxAmbience);
+    if (std::abs(ambience - m_AmbienceVolume) > 0.01f)
+    {
+        m_AmbienceVolume = ambience;
+        Aether::AudioSystem::SetVolume(m_AmbienceSrcID, m_AmbienceVolume);
+    }
+
+    // The loudest emitters take turns, so groans are spread out instead of stacking.
+    // The timer only runs while someone is in range, so the first groan waits a full interval.
+    // Distance falloff for these comes from the engine's 3D attenuation, not from c.gain.
+    if (voiced == 0) { m_GroanTimer = 0.0f; return; }
+
+    m_GroanTimer += ts;
+    if (m_GroanTimer >= m_Settings.GroanInterval / (float)voiced)
+    {
+        m_GroanTimer = 0.0f;
+        const Candidate& c = m_Candidates[m_NextVoice++ % voiced];
+        m_Pool->PlayOneShotAt(m_GroanSoundID, emitters[c.index], m_Settings.VoiceGain);
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <Aether.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include "VoicePool.h"
+
+// --- CROWD AUDIO ---
+// Turns many zombie emitters into a few real voices. Emitters past MaxDistance
+// are culled, and only the MaxVoices loudest ones take turns playing groans
+// through the voice pool as 3D voices placed at the emitter, so the engine
+// pans and attenuates them against the listener. Every other audible emitter
+// adds to the volume of a single looping 2D ambience source. The mixer never
+// sees more than MaxVoices + 1 sources, however large the crowd. Until Init is
+// called, Update does nothing.
+class CrowdAudio
+{
+public:
+    struct Settings {
+        float    MaxDistance   = 40.0f; // emitters beyond this are culled
+        float    RefDistance   = 4.0f;  // distance at which the ranking gain falls to 1/2
+        uint32_t MaxVoices     = 4;     // loudest emitters that get real voices
+        float    GroanInterval = 2.5f;  // seconds between groans across the top-N
+        float    VoiceGain     = 0.6f;
+        float    AmbienceGain  = 0.05f;
+        float    MaxAmbience   = 0.4f;
+    };
+
+    void Init(Aether::UUID groanSoundID, VoicePool& pool);
+    void Shutdown();   // destroys the ambience source and gives the groan voices back to the pool
+    bool IsActive() const { return m_Pool != nullptr; }
+    void Update(float ts, const glm::vec3& listenerPos, const std::vector<glm::vec3>& emitters);
+
+    // Culls and ranks the emitters and returns how many get a real voice. Makes no
+    // audio calls, so it also works before Init and can be timed on its own.
+    uint32_t Select(const glm::vec3& listenerPos, const std::vector<glm::vec3>& emitters);
+
+    Settings& GetSettings() { return m_Settings; }
+    uint32_t  GetAudibleCount() const { return m_AudibleCount; }
+    float     GetAmbienceVolume() const { return m_AmbienceVolume; }
+
+private:
+    struct Candidate {
+        float    gain;
+        uint32_t index;
+    };
+
+    Settings               m_Settings;
+    VoicePool*             m_Pool          = nullptr;
+    Aether::UUID           m_GroanSoundID  = 0;
+    Aether::UUID           m_AmbienceSrcID = 0;
+    std::vector<Candidate> m_Candidates;
+    float                  m_GroanTimer     = 0.0f;
+    uint32_t               m_NextVoice      = 0;
+    uint32_t               m_AudibleCount   = 0;
+    float                  m_AmbienceVolume = 0.0f;
+};
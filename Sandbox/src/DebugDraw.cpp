@@ -0,0 +1,138 @@
+#include "DebugDraw.h"
+#include <cmath>
+
+// Vertices per PrimType: Line, Quad, QuadFilled, Arrow, Text.
+static constexpr uint32_t k_VertexCounts[] = { 2, 4, 4, 2, 1 };
+
+void DebugDraw::Begin(const glm::mat4& viewProj, const glm::vec2& viewportPos, const glm::vec2& viewportSize)
+{
+    m_ViewProj     = viewProj;
+    m_ViewportPos  = viewportPos;
+    m_ViewportSize = viewportSize;
+
+    // Frustum planes straight from the view-projection rows (Gribb/Hartmann).
+    auto row = [&](int r) { return glm::vec4(viewProj[0][r], viewProj[1][r], viewProj[2][r], viewProj[3][r]); };
+    glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+    m_Planes[0] = r3 + r0;  m_Planes[1] = r3 - r0;
+    m_Planes[2] = r3 + r1;  m_Planes[3] = r3 - r1;
+    m_Planes[4] = r3 + r2;  m_Planes[5] = r3 - r2;
+    for (auto& p : m_Planes)
+        p /= glm::length(glm::vec3(p));
+
+    m_Prims.clear();
+    m_World.clear();
+    m_Text.clear();
+}
+
+bool DebugDraw::IsVisible(const glm::vec3& center, float radius) const
+{
+    for (const auto& p : m_Planes)
+        if (glm::dot(glm::vec3(p), center) + p.w < -radius) return false;
+    return true;
+}
+
+void DebugDraw::Push(PrimType type, ImU32 color, float thickness, float headSize, uint32_t textOffset)
+{
+    m_Prims.push_back({ type, (uint32_t)m_World.size(), color, thickness, headSize, textOffset });
+}
+
+void DebugDraw::Line(const glm::vec3& a, const glm::vec3& b, ImU32 color, float thickness)
+{
+    Push(PrimType::Line, color, thickness, 0.0f, 0);
+    m_World.push_back(a);
+    m_World.push_back(b);
+}
+
+void DebugDraw::Quad(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3,
+                     ImU32 color, float thickness)
+{
+    Push(PrimType::Quad, color, thickness, 0.0f, 0);
+    m_World.insert(m_World.end(), { p0, p1, p2, p3 });
+}
+
+void DebugDraw::QuadFilled(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3,
+                           ImU32 color)
+{
+    Push(PrimType::QuadFilled, color, 0.0f, 0.0f, 0);
+    m_World.insert(m_World.end(), { p0, p1, p2, p3 });
+}
+
+void DebugDraw::Arrow(const glm::vec3& from, const glm::vec3& to, ImU32 color, float thickness, float headSize)
+{
+    Push(PrimType::Arrow, color, thickness, headSize, 0);
+    m_World.push_back(from);
+    m_World.push_back(to);
+}
+
+void DebugDraw::Text(const glm::vec3& pos, ImU32 color, const char* text)
+{
+    Push(PrimType::Text, color, 0.0f, 0.0f, (uint32_t)m_Text.size());
+    m_Text.append(text);
+    m_Text.push_back('\0');
+    m_World.push_back(pos);
+}
+
+void DebugDraw::Flush(ImDrawList* drawList)
+{
+    // Project every vertex in one pass; primitives then only read the results.
+    const size_t count = m_World.size();
+    m_Screen.resize(count);
+    m_OnScreen.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        glm::vec4 clip = m_ViewProj * glm::vec4(m_World[i], 1.0f);
+        m_OnScreen[i]  = clip.w > 0.0001f;
+        float invW     = 1.0f / clip.w;
+        m_Screen[i]    = m_ViewportPos + glm::vec2(( clip.x * invW * 0.5f + 0.5f) * m_ViewportSize.x,
+                                                   (-clip.y * invW * 0.5f + 0.5f) * m_ViewportSize.y);
+    }
+
+    auto im = [&](uint32_t v) { return ImVec2(m_Screen[v].x, m_Screen[v].y); };
+
+    for (const Prim& prim : m_Prims)
+    {
+        uint32_t v = prim.firstVertex;
+        bool visible = true;
+        for (uint32_t k = 0; k < k_VertexCounts[(uint8_t)prim.type]; k++)
+            visible &= m_OnScreen[v + k] != 0;
+        if (!visible) continue;
+
+        switch (prim.type)
+        {
+        case PrimType::Line:
+            drawList->AddLine(im(v), im(v + 1), prim.color, prim.thickness);
+            break;
+        case PrimType::Quad:
+            drawList->AddQuad(im(v), im(v + 1), im(v + 2), im(v + 3), prim.color, prim.thickness);
+            break;
+        case PrimType::QuadFilled:
+            drawList->AddQuadFilled(im(v), im(v + 1), im(v + 2), im(v + 3), prim.color);
+            break;
+        case PrimType::Arrow:
+        {
+            glm::vec2 a = m_Screen[v], b = m_Screen[v + 1];
+            glm::vec2 d = b - a;
+            float len = glm::length(d);
+            drawList->AddLine(im(v), im(v + 1), prim.color, prim.thickness);
+            if (len > 0.001f)
+            {
+                d /= len;
+                glm::vec2 n(-d.y, d.x);
+                glm::vec2 l = b - d * prim.headSize + n * (prim.headSize * 0.5f);
+                glm::vec2 r = b - d * prim.headSize - n * (prim.headSize * 0.5f);
+                drawList->AddTriangleFilled(im(v + 1), ImVec2(l.x, l.y), ImVec2(r.x, r.y), prim.color);
+            }
+            break;
+        }
+        case PrimType::Text:
+            drawList->AddText(im(v), prim.color, m_Text.c_str() + prim.textOffset);
+            break;
+        }
+    }
+
+    m_LastPrimitives = (uint32_t)m_Prims.size();
+    m_LastVertices   = (uint32_t)count;
+    m_Prims.clear();
+    m_World.clear();
+    m_Text.clear();
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <imgui.h>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// --- DEBUG DRAW ---
+// Collects world-space debug primitives for one frame. Flush() projects all of
+// their vertices in one tight loop and emits them into an ImDrawList. Callers
+// use IsVisible() to frustum-cull whole primitives before submitting them.
+class DebugDraw
+{
+public:
+    void Begin(const glm::mat4& viewProj, const glm::vec2& viewportPos, const glm::vec2& viewportSize);
+    bool IsVisible(const glm::vec3& center, float radius) const;
+
+    void Line      (const glm::vec3& a, const glm::vec3& b, ImU32 color, float thickness = 1.0f);
+    void Quad      (const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3,
+                    ImU32 color, float thickness = 1.0f);
+    void QuadFilled(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3,
+                    ImU32 color);
+    void Arrow     (const glm::vec3& from, const glm::vec3& to, ImU32 color, float thickness = 1.0f, float headSize = 4.0f);
+    void Text      (const glm::vec3& pos, ImU32 color, const char* text);
+
+    void Flush(ImDrawList* drawList);
+
+    uint32_t GetPrimitiveCount() const { return m_LastPrimitives; }
+    uint32_t GetVertexCount()    const { return m_LastVertices; }
+
+private:
+    enum class PrimType : uint8_t { Line, Quad, QuadFilled, Arrow, Text };
+
+    struct Prim {
+        PrimType type;
+        uint32_t firstVertex;
+        ImU32    color;
+        float    thickness;
+        float    headSize;
+        uint32_t textOffset;
+    };
+
+    void Push(PrimType type, ImU32 color, float thickness, float headSize, uint32_t textOffset);
+
+private:
+    glm::mat4 m_ViewProj     = glm::mat4(1.0f);
+    glm::vec4 m_Planes[6];
+    glm::vec2 m_ViewportPos  = glm::vec2(0.0f);
+    glm::vec2 m_ViewportSize = glm::vec2(1.0f);
+
+    std::vector<Prim>      m_Prims;
+    std::vector<glm::vec3> m_World;
+    std::vector<glm::vec2> m_Screen;
+    std::vector<uint8_t>   m_OnScreen;
+    std::string            m_Text;   // '\0'-separated labels
+
+    uint32_t m_LastPrimitives = 0;
+    uint32_t m_LastVertices   = 0;
+};
@@ -0,0 +1,90 @@
+#pragma once
+#include <Aether.h>
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+// --- ENTITY SPARSE SET ---
+// Per-entity records addressed by the entity's index bits. The records are
+// packed densely for iteration. Insert, lookup and removal are O(1); removal
+// swaps the last record into the freed slot, so dense order is not stable.
+// The entity itself is the stable handle. A recycled index with a different
+// version is never mistaken for the old entity. The index bits come from entt's
+// own entity traits, so a different ENTT_ID_TYPE or layout is picked up as is.
+template<typename T>
+class EntitySparseSet
+{
+public:
+    static constexpr uint32_t k_Invalid = 0xFFFFFFFFu;
+
+    T& Insert(Aether::Entity entity, const T& value)
+    {
+        uint32_t key = KeyOf(entity);
+        if (key >= m_Sparse.size()) m_Sparse.resize(key + 1, k_Invalid);
+
+        uint32_t slot = m_Sparse[key];
+        if (slot != k_Invalid && m_Dense[slot] == entity)
+            return m_Values[slot] = value;
+
+        m_Sparse[key] = (uint32_t)m_Dense.size();
+        m_Dense.push_back(entity);
+        m_Values.push_back(value);
+        return m_Values.back();
+    }
+
+    uint32_t IndexOf(Aether::Entity entity) const
+    {
+        uint32_t key = KeyOf(entity);
+        if (key >= m_Sparse.size()) return k_Invalid;
+        uint32_t slot = m_Sparse[key];
+        return (slot != k_Invalid && m_Dense[slot] == entity) ? slot : k_Invalid;
+    }
+
+    bool     Contains(Aether::Entity entity) const { return IndexOf(entity) != k_Invalid; }
+    T*       TryGet(Aether::Entity entity)       { uint32_t i = IndexOf(entity); return i != k_Invalid ? &m_Values[i] : nullptr; }
+    T&       Get(Aether::Entity entity)          { return m_Values[IndexOf(entity)]; }
+
+    bool Remove(Aether::Entity entity)
+    {
+        uint32_t slot = IndexOf(entity);
+        if (slot == k_Invalid) return false;
+        RemoveAt(slot);
+        return true;
+    }
+
+    void RemoveAt(uint32_t slot)
+    {
+        uint32_t last = (uint32_t)m_Dense.size() - 1;
+        m_Sparse[KeyOf(m_Dense[slot])] = k_Invalid;
+        if (slot != last) {
+            m_Dense[slot]  = m_Dense[last];
+            m_Values[slot] = std::move(m_Values[last]);
+            m_Sparse[KeyOf(m_Dense[slot])] = slot;
+        }
+        m_Dense.pop_back();
+        m_Values.pop_back();
+    }
+
+    void Clear()
+    {
+        m_Sparse.clear();
+        m_Dense.clear();
+        m_Values.clear();
+    }
+
+    uint32_t       Size()  const { return (uint32_t)m_Dense.size(); }
+    bool           Empty() const { return m_Dense.empty(); }
+    Aether::Entity EntityAt(uint32_t slot) const { return m_Dense[slot]; }
+    T&             At(uint32_t slot)       { return m_Values[slot]; }
+    const T&       At(uint32_t slot) const { return m_Values[slot]; }
+
+    const std::vector<Aether::Entity>& Entities() const { return m_Dense; }
+
+private:
+    static uint32_t KeyOf(Aether::Entity entity) { return static_cast<uint32_t>(entt::to_entity(entity)); }
+
+private:
+    std::vector<uint32_t>       m_Sparse;
+    std::vector<Aether::Entity> m_Dense;
+    std::vector<T>              m_Values;
+};
@@ -0,0 +1,32 @@
+#include "FlowField.h"
+
+FlowField::FlowField(int radius)
+    : m_Radius(radius), m_Side(2 * radius + 3), m_Cells((size_t)m_Side * m_Side)
+{
+}
+
+void FlowField::ComputeDirections()
+{
+    for (int iz = 0; iz < m_Side; iz++)
+    {
+        for (int ix = 0; ix < m_Side; ix++)
+        {
+            FlowCell& cell = m_Cells[iz * m_Side + ix];
+            if (cell.cost >= k_Blocked || cell.bestCost == k_Unreached) continue;
+
+            glm::vec3 avgDir(0.0f);
+            for (const auto& [dx, dz] : k_Neighbors)
+            {
+                const int nx = ix + dx, nz = iz + dz;
+                if (nx < 0 || nz < 0 || nx >= m_Side || nz >= m_Side) continue;
+
+                const int neighborCost = m_Cells[nz * m_Side + nx].bestCost;
+                if (neighborCost < cell.bestCost) {
+                    float pullStrength = float(cell.bestCost - neighborCost);
+                    avgDir += glm::normalize(glm::vec3((float)dx, 0.0f, (float)dz)) * pullStrength;
+                }
+            }
+            cell.direction = (glm::length(avgDir) > 0.01f) ? glm::normalize(avgDir) : glm::vec3(0.0f);
+        }
+    }
+}
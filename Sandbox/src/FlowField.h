@@ -0,0 +1,100 @@
+#pragma once
+#include "FrameArena.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstdlib>
+
+// --- FLOW FIELD ---
+struct FlowCell {
+    int       cost      = 1;
+    int       bestCost  = 999999;
+    glm::vec3 direction = glm::vec3(0.0f);
+};
+
+// Flat (2 * radius + 3)^2 grid of path cells centred on the last target. The
+// BFS expands cells up to radius away from the target, and their neighbours
+// one ring further out still get a cost. A rebuild moves the grid to the new
+// target and rewrites the cells in place, so after the first Build the field
+// no longer allocates. The open list lives in the frame arena.
+class FlowField
+{
+public:
+    static constexpr int k_Unreached = 999999;
+    static constexpr int k_Blocked   = 255;   // cost at or above this is never entered
+
+    explicit FlowField(int radius = 40);
+
+    // costAt(x, z) returns the cost of entering a cell, k_Blocked or more for walls.
+    template<typename CostFn>
+    void Build(int targetX, int targetZ, FrameArena& arena, CostFn&& costAt)
+    {
+        m_MinX = targetX - m_Radius - 1;
+        m_MinZ = targetZ - m_Radius - 1;
+        for (int iz = 0; iz < m_Side; iz++)
+            for (int ix = 0; ix < m_Side; ix++)
+                m_Cells[iz * m_Side + ix] = { costAt(m_MinX + ix, m_MinZ + iz), k_Unreached, glm::vec3(0.0f) };
+
+        FlowCell& target = m_Cells[Index(targetX, targetZ)];
+        target.bestCost = 0;
+        target.cost     = 1;
+
+        // FIFO over a frame-arena vector; popped entries are just skipped by openHead.
+        FrameVector<std::pair<int, int>> openList(arena);
+        openList.reserve((size_t)m_Side * m_Side);
+        openList.push_back({ targetX, targetZ });
+        size_t openHead = 0;
+
+        while (openHead < openList.size())
+        {
+            const auto current = openList[openHead++];
+            if (std::abs(current.first  - targetX) > m_Radius ||
+                std::abs(current.second - targetZ) > m_Radius) continue;
+
+            const int currCost = m_Cells[Index(current.first, current.second)].bestCost;
+            for (const auto& [dx, dz] : k_Neighbors)
+            {
+                FlowCell& neighbor = m_Cells[Index(current.first + dx, current.second + dz)];
+                if (neighbor.cost >= k_Blocked) continue;
+
+                const int moveCost = (dx != 0 && dz != 0) ? 14 : 10;
+                const int newCost  = currCost + moveCost * neighbor.cost;
+                if (newCost < neighbor.bestCost) {
+                    neighbor.bestCost = newCost;
+                    openList.push_back({ current.first + dx, current.second + dz });
+                }
+            }
+        }
+
+        ComputeDirections();
+    }
+
+    // nullptr outside the grid.
+    const FlowCell* Find(int x, int z) const
+    {
+        if (x < m_MinX || z < m_MinZ || x >= m_MinX + m_Side || z >= m_MinZ + m_Side) return nullptr;
+        return &m_Cells[Index(x, z)];
+    }
+
+    int GetMinX() const { return m_MinX; }
+    int GetMinZ() const { return m_MinZ; }
+    int GetSide() const { return m_Side; }
+    const FlowCell& At(int ix, int iz) const { return m_Cells[iz * m_Side + ix]; }   // grid-local
+
+private:
+    static constexpr std::pair<int, int> k_Neighbors[8] = {
+        {0, 1}, {0,-1}, {1, 0}, {-1, 0},
+        {1, 1}, {1,-1}, {-1, 1}, {-1,-1}
+    };
+
+    int  Index(int x, int z) const { return (z - m_MinZ) * m_Side + (x - m_MinX); }
+    void ComputeDirections();
+
+private:
+    int                   m_Radius;
+    int                   m_Side;
+    int                   m_MinX = 0;
+    int                   m_MinZ = 0;
+    std::vector<FlowCell> m_Cells;
+};
@@ -0,0 +1,55 @@
+#include "FrameArena.h"
+#include <algorithm>
+
+FrameArena::FrameArena(size_t initialSize)
+{
+    AddBlock(initialSize);
+}
+
+void FrameArena::AddBlock(size_t size)
+{
+    m_Blocks.push_back({ std::make_unique<std::byte[]>(size), size });
+    m_Capacity += size;
+}
+
+void* FrameArena::Allocate(size_t size, size_t align)
+{
+    uintptr_t base    = (uintptr_t)m_Blocks[m_Current].Data.get();
+    uintptr_t aligned = (base + m_Offset + align - 1) & ~(uintptr_t)(align - 1);
+
+    if (aligned + size > base + m_Blocks[m_Current].Size)
+    {
+        AddBlock(std::max(size + align, m_Blocks[m_Current].Size));
+        m_Grew    = true;
+        m_Current = m_Blocks.size() - 1;
+        m_Offset  = 0;
+        base     = (uintptr_t)m_Blocks[m_Current].Data.get();
+        aligned  = (base + align - 1) & ~(uintptr_t)(align - 1);
+    }
+
+    m_Used  += (aligned + size) - (base + m_Offset);
+    m_Offset = (aligned + size) - base;
+    m_Peak   = std::max(m_Peak, m_Used);
+    return (void*)aligned;
+}
+
+void FrameArena::Reset()
+{
+    m_LastFrameUsed   = m_Used;
+    m_LastFrameBlocks = m_Blocks.size();
+
+    if (m_Blocks.size() > 1)
+    {
+        // One block sized for everything this frame took, so the next frame fits without chaining.
+        size_t total = m_Capacity;
+        m_Blocks.clear();
+        m_Capacity = 0;
+        AddBlock(total);
+    }
+    if (m_Grew) m_GrowCount++;
+
+    m_Current = 0;
+    m_Offset  = 0;
+    m_Used    = 0;
+    m_Grew    = false;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <cstddef>
+#include <cstdint>
+
+// --- FRAME ARENA ---
+// Bump allocator for containers that only live for one frame. Allocating moves
+// an offset forward, deallocating does nothing, and Reset() rewinds the whole
+// arena at the end of MainGameLayer::Update. If a frame outgrows the current
+// block, another block is chained on. The next Reset() merges the blocks into
+// one that fits the whole frame, so once the arena has grown to the largest
+// frame, the containers it backs stop allocating. Containers use the arena
+// through FrameAllocator<T> or through Resource() for std::pmr. Nothing
+// allocated here may be kept past Reset().
+
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t initialSize = 256 * 1024);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* Allocate(size_t size, size_t align);
+    void  Reset();
+
+    size_t   GetUsed()            const { return m_Used; }            // this frame, alignment padding included
+    size_t   GetLastFrameUsed()   const { return m_LastFrameUsed; }   // as of the last Reset()
+    size_t   GetLastFrameBlocks() const { return m_LastFrameBlocks; } // blocks chained before the last Reset()
+    size_t   GetPeak()            const { return m_Peak; }            // high-water mark over all frames
+    size_t   GetCapacity()        const { return m_Capacity; }
+    uint32_t GetGrowCount()       const { return m_GrowCount; }       // frames that needed another block
+
+    std::pmr::memory_resource* Resource() { return &m_Resource; }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> Data;
+        size_t                       Size = 0;
+    };
+
+    class ArenaResource : public std::pmr::memory_resource
+    {
+    public:
+        explicit ArenaResource(FrameArena& arena) : m_Arena(arena) {}
+
+    private:
+        void* do_allocate(size_t bytes, size_t align) override { return m_Arena.Allocate(bytes, align); }
+        void  do_deallocate(void*, size_t, size_t) override {}
+        bool  do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        FrameArena& m_Arena;
+    };
+
+    void AddBlock(size_t size);
+
+    std::vector<Block> m_Blocks;
+    size_t             m_Current         = 0;   // block being bumped, always the last one
+    size_t             m_Offset          = 0;   // into m_Blocks[m_Current]
+    size_t             m_Used            = 0;
+    size_t             m_LastFrameUsed   = 0;
+    size_t             m_LastFrameBlocks = 1;
+    size_t             m_Peak            = 0;
+    size_t             m_Capacity        = 0;
+    uint32_t           m_GrowCount       = 0;
+    bool               m_Grew            = false;
+    ArenaResource      m_Resource { *this };
+};
+
+template<typename T>
+class FrameAllocator
+{
+public:
+    using value_type = T;
+
+    FrameAllocator(FrameArena& arena) : m_Arena(&arena) {}
+    template<typename U>
+    FrameAllocator(const FrameAllocator<U>& other) : m_Arena(other.m_Arena) {}
+
+    T*   allocate(size_t n)     { return static_cast<T*>(m_Arena->Allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) {}
+
+    template<typename U> bool operator==(const FrameAllocator<U>& other) const { return m_Arena == other.m_Arena; }
+    template<typename U> bool operator!=(const FrameAllocator<U>& other) const { return m_Arena != other.m_Arena; }
+
+private:
+    template<typename U> friend class FrameAllocator;
+    FrameArena* m_Arena;
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
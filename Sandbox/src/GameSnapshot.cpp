@@ -0,0 +1,247 @@
+#include "GameSnapshot.h"
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace Snapshot {
+
+    static constexpr uint64_t k_Alignment = 16;
+
+    static uint64_t AlignUp(uint64_t value)
+    {
+        return (value + k_Alignment - 1) & ~(k_Alignment - 1);
+    }
+
+    // Forces a written file's data out of the OS cache onto the disk.
+    static bool SyncFile(const std::string& path)
+    {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        bool ok = FlushFileBuffers(file) != 0;
+        CloseHandle(file);
+        return ok;
+#else
+        int fd = ::open(path.c_str(), O_WRONLY);
+        if (fd < 0) return false;
+        bool ok = ::fsync(fd) == 0;
+        ::close(fd);
+        return ok;
+#endif
+    }
+
+    // Makes a rename inside the directory durable. Windows has no equivalent, so this is a no-op there.
+    static void SyncParentDirectory(const std::string& path)
+    {
+#ifndef _WIN32
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        int fd = ::open(parent.empty() ? "." : parent.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        ::fsync(fd);
+        ::close(fd);
+#else
+        (void)path;
+#endif
+    }
+
+    bool Write(const std::string& path, const Data& data)
+    {
+        struct Section { uint32_t tag; uint32_t stride; uint64_t count; const void* bytes; };
+        const Section sections[] = {
+            { k_TagMeta,    sizeof(Meta),   1,                   &data.MetaInfo },
+            { k_TagPlayer,  sizeof(Player), 1,                   &data.PlayerState },
+            { k_TagChunks,  sizeof(Chunk),  data.Chunks.size(),  data.Chunks.data() },
+            { k_TagZombies, sizeof(Zombie), data.Zombies.size(), data.Zombies.data() },
+        };
+        constexpr uint32_t sectionCount = sizeof(sections) / sizeof(sections[0]);
+
+        Header header { k_Magic, k_Version, sectionCount, 0 };
+        TocEntry toc[sectionCount];
+
+        uint64_t offset = AlignUp(sizeof(Header) + sizeof(toc));
+        for (uint32_t i = 0; i < sectionCount; i++)
+        {
+            toc[i]  = { sections[i].tag, sections[i].stride, offset, sections[i].count };
+            offset  = AlignUp(offset + sections[i].stride * sections[i].count);
+        }
+
+        // Write next to the target, flush it to disk, then swap it in: after a crash or power
+        // loss, path holds either the previous save or this one, never a partial file.
+        const std::string tmpPath = path + ".tmp";
+        std::error_code   ec;
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out) return false;
+
+            static const char zeros[k_Alignment] = {};
+            uint64_t written = 0;
+            auto put = [&](const void* bytes, uint64_t size) {
+                out.write(static_cast<const char*>(bytes), (std::streamsize)size);
+                written += size;
+            };
+            auto pad = [&](uint64_t target) { put(zeros, target - written); };
+
+            put(&header, sizeof(header));
+            put(toc, sizeof(toc));
+            for (uint32_t i = 0; i < sectionCount; i++)
+            {
+                pad(toc[i].Offset);
+                put(sections[i].bytes, sections[i].stride * sections[i].count);
+            }
+            pad(offset);
+            out.close();   // close() flushes; a write error may only show up here
+            if (out.fail()) { std::filesystem::remove(tmpPath, ec); return false; }
+        }
+
+        if (!SyncFile(tmpPath)) { std::filesystem::remove(tmpPath, ec); return false; }
+
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec) return false;
+        SyncParentDirectory(path);
+        return true;
+    }
+
+    File::~File()
+    {
+        Close();
+    }
+
+    File::File(File&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    File& File::operator=(File&& other) noexcept
+    {
+        if (this == &other) return *this;
+        Close();
+        m_Data   = other.m_Data;   other.m_Data = nullptr;
+        m_Size   = other.m_Size;   other.m_Size = 0;
+        m_Legacy = other.m_Legacy;
+#ifdef _WIN32
+        m_FileHandle    = other.m_FileHandle;    other.m_FileHandle    = nullptr;
+        m_MappingHandle = other.m_MappingHandle; other.m_MappingHandle = nullptr;
+#else
+        m_Fd = other.m_Fd; other.m_Fd = -1;
+#endif
+        return *this;
+    }
+
+    bool File::Open(const std::string& path)
+    {
+        Close();
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) { CloseHandle(file); return false; }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) { CloseHandle(file); return false; }
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) { CloseHandle(mapping); CloseHandle(file); return false; }
+
+        m_FileHandle    = file;
+        m_MappingHandle = mapping;
+        m_Data          = static_cast<const uint8_t*>(view);
+        m_Size          = (size_t)size.QuadPart;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) { ::close(fd); return false; }
+
+        void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) { ::close(fd); return false; }
+
+        m_Fd   = fd;
+        m_Data = static_cast<const uint8_t*>(view);
+        m_Size = (size_t)st.st_size;
+#endif
+
+        // Pre-snapshot saves are exactly two raw uint32_t values.
+        m_Legacy = false;
+        if (m_Size == sizeof(uint32_t) * 2) { m_Legacy = true; return true; }
+
+        if (m_Size < sizeof(Header)) { Close(); return false; }
+        const Header* header = reinterpret_cast<const Header*>(m_Data);
+        if (header->Magic != k_Magic || header->Version != k_Version ||
+            sizeof(Header) + (uint64_t)header->SectionCount * sizeof(TocEntry) > m_Size)
+        {
+            Close();
+            return false;
+        }
+
+        const TocEntry* toc = reinterpret_cast<const TocEntry*>(m_Data + sizeof(Header));
+        for (uint32_t i = 0; i < header->SectionCount; i++)
+        {
+            const TocEntry& e = toc[i];
+            if (e.Offset % k_Alignment != 0 || e.Stride == 0 ||
+                e.Count > (m_Size - std::min<uint64_t>(e.Offset, m_Size)) / e.Stride)
+            {
+                Close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void File::Close()
+    {
+#ifdef _WIN32
+        if (m_Data)          UnmapViewOfFile(m_Data);
+        if (m_MappingHandle) CloseHandle(m_MappingHandle);
+        if (m_FileHandle)    CloseHandle(m_FileHandle);
+        m_MappingHandle = nullptr;
+        m_FileHandle    = nullptr;
+#else
+        if (m_Data)    munmap(const_cast<uint8_t*>(m_Data), m_Size);
+        if (m_Fd >= 0) ::close(m_Fd);
+        m_Fd = -1;
+#endif
+        m_Data   = nullptr;
+        m_Size   = 0;
+        m_Legacy = false;
+    }
+
+    bool File::ReadLegacy(uint32_t& highScore, uint32_t& zombiesKilled) const
+    {
+        if (!m_Legacy) return false;
+        std::memcpy(&highScore,     m_Data,                    sizeof(uint32_t));
+        std::memcpy(&zombiesKilled, m_Data + sizeof(uint32_t), sizeof(uint32_t));
+        return true;
+    }
+
+    const TocEntry* File::Find(uint32_t tag) const
+    {
+        if (!m_Data || m_Legacy) return nullptr;
+        const Header*   header = reinterpret_cast<const Header*>(m_Data);
+        const TocEntry* toc    = reinterpret_cast<const TocEntry*>(m_Data + sizeof(Header));
+        for (uint32_t i = 0; i < header->SectionCount; i++)
+            if (toc[i].Tag == tag) return &toc[i];
+        return nullptr;
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// --- GAME SNAPSHOT ---
+// Versioned binary save file:
+//
+//   Header | TOC entry x sectionCount | section data (each 16-byte aligned)
+//
+// Every section is a flat array of the POD records below. A loader maps the
+// file into memory and reads those arrays in place, so large sections such as
+// the crowd are never copied. Unknown section tags are skipped. That lets newer
+// files add sections without breaking older readers, as long as the version
+// stays the same.
+
+namespace Snapshot {
+
+    constexpr uint32_t MakeTag(char a, char b, char c, char d)
+    {
+        return (uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24);
+    }
+
+    constexpr uint32_t k_Magic   = MakeTag('T', 'L', 'E', 'S');
+    constexpr uint32_t k_Version = 1;
+
+    constexpr uint32_t k_TagMeta    = MakeTag('M', 'E', 'T', 'A');
+    constexpr uint32_t k_TagPlayer  = MakeTag('P', 'L', 'Y', 'R');
+    constexpr uint32_t k_TagChunks  = MakeTag('C', 'H', 'N', 'K');
+    constexpr uint32_t k_TagZombies = MakeTag('Z', 'O', 'M', 'B');
+
+    struct Header {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t SectionCount;
+        uint32_t Reserved;
+    };
+
+    struct TocEntry {
+        uint32_t Tag;
+        uint32_t Stride;     // bytes per record
+        uint64_t Offset;     // from start of file
+        uint64_t Count;      // number of records
+    };
+
+    struct Meta {
+        uint32_t HighScore;
+        uint32_t ZombiesKilled;
+        uint32_t Reserved[2];
+    };
+
+    struct Player {
+        float    Position[3];
+        float    Rotation[4];      // w, x, y, z
+        float    Health;
+        float    DamageCooldown;
+        int32_t  Ammo;
+        uint32_t Reloading;
+        float    ReloadTimer;
+        float    CameraYaw;
+        float    CameraPitch;
+        float    CameraDistance;
+        uint32_t FirstPerson;
+    };
+
+    struct Chunk {
+        int32_t X, Z;
+        int32_t Rotation;          // 0-3, multiples of 90 degrees
+        int32_t Reserved;
+    };
+
+    struct Zombie {
+        float   Position[3];
+        float   Rotation[4];       // w, x, y, z
+        int32_t ChunkX, ChunkZ;    // owning chunk, valid when OwnedByChunk != 0
+        int32_t OwnedByChunk;
+    };
+
+    // Everything needed to write a snapshot; filled on the main thread, written on a worker.
+    struct Data {
+        Meta                MetaInfo {};
+        Player              PlayerState {};
+        std::vector<Chunk>  Chunks;
+        std::vector<Zombie> Zombies;
+    };
+
+    bool Write(const std::string& path, const Data& data);
+
+    // Read-only memory mapping of a snapshot file.
+    class File
+    {
+    public:
+        File() = default;
+        ~File();
+        File(const File&) = delete;
+        File& operator=(const File&) = delete;
+        File(File&& other) noexcept;
+        File& operator=(File&& other) noexcept;
+
+        bool Open(const std::string& path);
+        void Close();
+
+        bool     IsOpen()  const { return m_Data != nullptr; }
+        bool     IsLegacy() const { return m_Legacy; }   // pre-snapshot save.dat (two raw uint32_t)
+        size_t   Size()    const { return m_Size; }
+
+        // Zero-copy view of a section, or nullptr if it is missing or malformed.
+        template<typename T>
+        const T* Get(uint32_t tag, uint64_t& outCount) const
+        {
+            const TocEntry* entry = Find(tag);
+            if (!entry || entry->Stride != sizeof(T)) { outCount = 0; return nullptr; }
+            outCount = entry->Count;
+            return reinterpret_cast<const T*>(m_Data + entry->Offset);
+        }
+
+        bool ReadLegacy(uint32_t& highScore, uint32_t& zombiesKilled) const;
+
+    private:
+        const TocEntry* Find(uint32_t tag) const;
+
+    private:
+        const uint8_t* m_Data   = nullptr;
+        size_t         m_Size   = 0;
+        bool           m_Legacy = false;
+#ifdef _WIN32
+        void*          m_FileHandle    = nullptr;
+        void*          m_MappingHandle = nullptr;
+#else
+        int            m_Fd = -1;
+#endif
+    };
+}
@@ -0,0 +1,189 @@
+#include "Hitscan.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cfloat>
+#include <cassert>
+
+static constexpr uint32_t k_LeafSize  = 4;
+static constexpr uint32_t k_StackSize = 64;  // traversal needs depth + 1 slots; median splits keep depth near log2(n)
+
+void HitscanBVH::Build(const std::vector<Capsule>& capsules)
+{
+    m_Capsules = capsules;
+    m_Nodes.clear();
+    m_Indices.clear();
+    m_Depth = 0;
+
+    m_Centers.resize(m_Capsules.size());
+    for (uint32_t i = 0; i < (uint32_t)m_Capsules.size(); i++)
+    {
+        m_Centers[i] = m_Capsules[i].Base + glm::vec3(0.0f, m_Capsules[i].Height * 0.5f, 0.0f);
+        if (m_Capsules[i].Radius > 0.0f) m_Indices.push_back(i);
+    }
+
+    const uint32_t count = (uint32_t)m_Indices.size();
+    if (count == 0) return;
+
+    m_Nodes.reserve(count * 2);
+    m_Nodes.emplace_back();
+    Subdivide(0, 0, count, 0);
+    assert(m_Depth + 1 <= k_StackSize);
+}
+
+void HitscanBVH::Subdivide(uint32_t nodeIndex, uint32_t first, uint32_t count, uint32_t depth)
+{
+    m_Depth = std::max(m_Depth, depth);
+
+    glm::vec3 bmin(FLT_MAX), bmax(-FLT_MAX);
+    glm::vec3 cmin(FLT_MAX), cmax(-FLT_MAX);
+    for (uint32_t i = first; i < first + count; i++)
+    {
+        const Capsule& c = m_Capsules[m_Indices[i]];
+        bmin = glm::min(bmin, c.Base - glm::vec3(c.Radius, 0.0f, c.Radius));
+        bmax = glm::max(bmax, c.Base + glm::vec3(c.Radius, c.Height, c.Radius));
+        cmin = glm::min(cmin, m_Centers[m_Indices[i]]);
+        cmax = glm::max(cmax, m_Centers[m_Indices[i]]);
+    }
+    m_Nodes[nodeIndex].Min = bmin;
+    m_Nodes[nodeIndex].Max = bmax;
+
+    if (count <= k_LeafSize)
+    {
+        m_Nodes[nodeIndex].First = first;
+        m_Nodes[nodeIndex].Count = count;
+        return;
+    }
+
+    // Median split on the longest axis of the centroid bounds.
+    glm::vec3 extent = cmax - cmin;
+    int axis = (extent.y > extent.x) ? 1 : 0;
+    if (extent.z > extent[axis]) axis = 2;
+
+    uint32_t half = count / 2;
+    std::nth_element(m_Indices.begin() + first, m_Indices.begin() + first + half, m_Indices.begin() + first + count,
+        [&](uint32_t a, uint32_t b) { return m_Centers[a][axis] < m_Centers[b][axis]; });
+
+    uint32_t left = (uint32_t)m_Nodes.size();
+    m_Nodes.emplace_back();
+    m_Nodes.emplace_back();
+    m_Nodes[nodeIndex].First = left;
+    m_Nodes[nodeIndex].Count = 0;
+
+    Subdivide(left,     first,        half,         depth + 1);
+    Subdivide(left + 1, first + half, count - half, depth + 1);
+}
+
+bool HitscanBVH::Cast(const ShotRay& ray, uint32_t& outTarget, float& outDistance) const
+{
+    if (m_Nodes.empty()) return false;
+
+    const glm::vec3 invDir = 1.0f / ray.Direction;
+    float best = ray.MaxDistance;
+    bool  hit  = false;
+
+    uint32_t stack[k_StackSize];
+    int      sp = 0;
+    stack[sp++] = 0;
+
+    while (sp > 0)
+    {
+        const Node& node = m_Nodes[stack[--sp]];
+        if (!IntersectAABB(ray, invDir, node.Min, node.Max, best)) continue;
+
+        if (node.Count > 0)
+        {
+            for (uint32_t i = node.First; i < node.First + node.Count; i++)
+            {
+                float t = IntersectCapsule(ray, m_Capsules[m_Indices[i]]);
+                if (t >= 0.0f && t < best) { best = t; outTarget = m_Indices[i]; hit = true; }
+            }
+        }
+        else
+        {
+            assert(sp + 2 <= (int)k_StackSize);
+            stack[sp++] = node.First;
+            stack[sp++] = node.First + 1;
+        }
+    }
+
+    if (hit) outDistance = best;
+    return hit;
+}
+
+void HitscanBVH::CastBatch(const std::vector<ShotRay>& rays, std::vector<ShotHit>& outHits) const
+{
+    outHits.clear();
+    for (uint32_t r = 0; r < (uint32_t)rays.size(); r++)
+    {
+        ShotHit hit;
+        if (Cast(rays[r], hit.Target, hit.Distance))
+        {
+            hit.Ray = r;
+            outHits.push_back(hit);
+        }
+    }
+}
+
+// Ray vs. capsule (segment + radius), returns the entry distance or -1 on miss.
+float HitscanBVH::IntersectCapsule(const ShotRay& ray, const Capsule& capsule)
+{
+    const glm::vec3 pa = capsule.Base + glm::vec3(0.0f, capsule.Radius, 0.0f);
+    const glm::vec3 pb = capsule.Base + glm::vec3(0.0f, std::max(capsule.Height - capsule.Radius, capsule.Radius), 0.0f);
+    const float     r  = capsule.Radius;
+
+    const glm::vec3 ba = pb - pa;
+    const glm::vec3 oa = ray.Origin - pa;
+    const glm::vec3& rd = ray.Direction;
+
+    float baba = glm::dot(ba, ba);
+    float bard = glm::dot(ba, rd);
+    float baoa = glm::dot(ba, oa);
+    float rdoa = glm::dot(rd, oa);
+    float oaoa = glm::dot(oa, oa);
+
+    float a = baba - bard * bard;
+    float b = baba * rdoa - baoa * bard;
+    float c = baba * oaoa - baoa * baoa - r * r * baba;
+    float h = b * b - a * c;
+
+    if (a > 1e-6f && h >= 0.0f)
+    {
+        float t = (-b - std::sqrt(h)) / a;
+        float y = baoa + t * bard;
+        if (y > 0.0f && y < baba) return t;  // body
+        glm::vec3 oc = (y <= 0.0f) ? oa : ray.Origin - pb;
+        b = glm::dot(rd, oc);
+        c = glm::dot(oc, oc) - r * r;
+        h = b * b - c;
+        if (h > 0.0f) return -b - std::sqrt(h);
+        return -1.0f;
+    }
+
+    // Ray (nearly) parallel to the axis: only the caps can be hit.
+    float best = -1.0f;
+    for (const glm::vec3& centre : { pa, pb })
+    {
+        glm::vec3 oc = ray.Origin - centre;
+        float cb = glm::dot(rd, oc);
+        float cc = glm::dot(oc, oc) - r * r;
+        float ch = cb * cb - cc;
+        if (ch <= 0.0f) continue;
+        float t = -cb - std::sqrt(ch);
+        if (t >= 0.0f && (best < 0.0f || t < best)) best = t;
+    }
+    return best;
+}
+
+bool HitscanBVH::IntersectAABB(const ShotRay& ray, const glm::vec3& invDir,
+                               const glm::vec3& bmin, const glm::vec3& bmax, float maxT)
+{
+    glm::vec3 t1 = (bmin - ray.Origin) * invDir;
+    glm::vec3 t2 = (bmax - ray.Origin) * invDir;
+    glm::vec3 tsmall = glm::min(t1, t2);
+    glm::vec3 tbig   = glm::max(t1, t2);
+
+    float tmin = std::max(std::max(tsmall.x, tsmall.y), std::max(tsmall.z, 0.0f));
+    float tmax = std::min(std::min(tbig.x, tbig.y), tbig.z);
+    return tmax >= tmin && tmin <= maxT;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cmath>
+
+// --- HITSCAN ---
+// Rays fired between two simulation ticks are queued and cast together against
+// a BVH of vertical capsules, which is rebuilt from the agents' positions once
+// per batch.
+
+struct ShotRay {
+    glm::vec3 Origin;
+    glm::vec3 Direction;   // normalized
+    float     MaxDistance;
+};
+
+struct ShotHit {
+    uint32_t Ray;          // index into the ray batch
+    uint32_t Target;       // index into the capsule array passed to Build
+    float    Distance;
+};
+
+class HitscanBVH
+{
+public:
+    struct Capsule {
+        glm::vec3 Base;    // feet position
+        float     Radius;  // 0 marks an empty slot: kept so indices line up, left out of the tree
+        float     Height;  // total height, caps included
+    };
+
+    void Build(const std::vector<Capsule>& capsules);
+    bool Cast(const ShotRay& ray, uint32_t& outTarget, float& outDistance) const;
+    void CastBatch(const std::vector<ShotRay>& rays, std::vector<ShotHit>& outHits) const;
+
+    bool Empty() const { return m_Nodes.empty(); }
+
+    static float IntersectCapsule(const ShotRay& ray, const Capsule& capsule);   // entry distance, -1 on miss
+
+private:
+    struct Node {
+        glm::vec3 Min, Max;
+        uint32_t  First = 0;  // first child (inner) or first index (leaf)
+        uint32_t  Count = 0;  // 0 for inner nodes
+    };
+
+    void Subdivide(uint32_t nodeIndex, uint32_t first, uint32_t count, uint32_t depth);
+
+    static bool  IntersectAABB(const ShotRay& ray, const glm::vec3& invDir,
+                               const glm::vec3& bmin, const glm::vec3& bmax, float maxT);
+
+private:
+    std::vector<Capsule>   m_Capsules;
+    std::vector<glm::vec3> m_Centers;
+    std::vector<uint32_t>  m_Indices;
+    std::vector<Node>      m_Nodes;
+    uint32_t               m_Depth = 0;   // levels below the root
+};
+
+// Walks the square XZ cells the ray crosses (2D DDA) and returns the distance at which
+// it enters the first cell isSolid(x, z) accepts, or ray.MaxDistance if none is closer.
+// The origin cell is skipped, so a camera standing in a wall cell can still shoot out.
+template<typename IsSolid>
+float ClipRayToGrid(const ShotRay& ray, float cellSize, IsSolid&& isSolid)
+{
+    const float inf = std::numeric_limits<float>::infinity();
+    const float dx  = ray.Direction.x;
+    const float dz  = ray.Direction.z;
+
+    int       cx    = (int)std::floor(ray.Origin.x / cellSize);
+    int       cz    = (int)std::floor(ray.Origin.z / cellSize);
+    const int stepX = dx > 0.0f ? 1 : -1;
+    const int stepZ = dz > 0.0f ? 1 : -1;
+
+    // Ray distance to the next boundary on each axis, and per whole cell after that.
+    float       tMaxX   = dx != 0.0f ? ((cx + (stepX > 0)) * cellSize - ray.Origin.x) / dx : inf;
+    float       tMaxZ   = dz != 0.0f ? ((cz + (stepZ > 0)) * cellSize - ray.Origin.z) / dz : inf;
+    const float tDeltaX = dx != 0.0f ? cellSize / std::abs(dx) : inf;
+    const float tDeltaZ = dz != 0.0f ? cellSize / std::abs(dz) : inf;
+
+    for (;;)
+    {
+        float t;
+        if (tMaxX < tMaxZ) { t = tMaxX; cx += stepX; tMaxX += tDeltaX; }
+        else               { t = tMaxZ; cz += stepZ; tMaxZ += tDeltaZ; }
+
+        if (t >= ray.MaxDistance) return ray.MaxDistance;
+        if (isSolid(cx, cz))      return t;
+    }
+}
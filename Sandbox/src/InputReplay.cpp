@@ -0,0 +1,173 @@
+#include "InputReplay.h"
+#include <cstring>
+#include <cstddef>
+
+namespace {
+    constexpr uint32_t k_Magic         = 'T' | ('L' << 8) | ('I' << 16) | ('R' << 24);
+    constexpr uint32_t k_Version       = 2;   // 2: Fire actions carry their shot ray
+    constexpr uint32_t k_FlushInterval = 60;   // frames; bounds what a crash can lose
+
+    struct Header {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t Seed;
+        uint32_t TickRate;
+        uint32_t FrameCount;
+        uint32_t Reserved;
+    };
+}
+
+// =============================================================================
+//  InputRecorder
+// =============================================================================
+
+bool InputRecorder::Open(const std::string& path, uint32_t seed, uint32_t tickRate)
+{
+    Close();
+    m_Out.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_Out) return false;
+
+    // Frame count is patched in by Close(); playback does not depend on it.
+    Header header { k_Magic, k_Version, seed, tickRate, 0, 0 };
+    m_Out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_FrameCount = 0;
+    return true;
+}
+
+void InputRecorder::Write(const InputFrame& frame, const std::vector<InputAction>& actions)
+{
+    if (!m_Out.is_open()) return;
+
+    InputFrame f  = frame;
+    f.ActionCount = (uint16_t)actions.size();
+    m_Out.write(reinterpret_cast<const char*>(&f), sizeof(f));
+    if (!actions.empty())
+        m_Out.write(reinterpret_cast<const char*>(actions.data()), sizeof(InputAction) * actions.size());
+    if (++m_FrameCount % k_FlushInterval == 0) m_Out.flush();
+}
+
+void InputRecorder::Close()
+{
+    if (!m_Out.is_open()) return;
+    m_Out.seekp(offsetof(Header, FrameCount));
+    m_Out.write(reinterpret_cast<const char*>(&m_FrameCount), sizeof(m_FrameCount));
+    m_Out.close();
+}
+
+// =============================================================================
+//  InputPlayback
+// =============================================================================
+
+bool InputPlayback::Open(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+
+    m_Data.resize((size_t)in.tellg());
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(m_Data.data()), (std::streamsize)m_Data.size());
+    if (!in || m_Data.size() < sizeof(Header)) return false;
+
+    Header header;
+    std::memcpy(&header, m_Data.data(), sizeof(header));
+    if (header.Magic != k_Magic || header.Version != k_Version) return false;
+    if (header.TickRate < k_MinSimTickRate || header.TickRate > k_MaxSimTickRate) return false;
+
+    // Count the complete frames. A recorder that crashed never patched FrameCount, and a
+    // frame cut off mid-write is dropped.
+    uint32_t frames = 0;
+    size_t   cursor = sizeof(Header);
+    while (cursor + sizeof(InputFrame) <= m_Data.size())
+    {
+        InputFrame frame;
+        std::memcpy(&frame, m_Data.data() + cursor, sizeof(frame));
+        const size_t next = cursor + sizeof(InputFrame) + sizeof(InputAction) * frame.ActionCount;
+        if (next > m_Data.size()) break;
+        cursor = next;
+        frames++;
+    }
+
+    m_Seed       = header.Seed;
+    m_TickRate   = header.TickRate;
+    m_FrameCount = frames;
+    m_FrameIndex = 0;
+    m_Cursor     = sizeof(Header);
+    return true;
+}
+
+bool InputPlayback::Next(InputFrame& outFrame, std::vector<InputAction>& outActions)
+{
+    outActions.clear();
+    if (m_FrameIndex >= m_FrameCount || m_Cursor + sizeof(InputFrame) > m_Data.size()) return false;
+
+    std::memcpy(&outFrame, m_Data.data() + m_Cursor, sizeof(InputFrame));
+    m_Cursor += sizeof(InputFrame);
+
+    const size_t actionBytes = sizeof(InputAction) * outFrame.ActionCount;
+    if (m_Cursor + actionBytes > m_Data.size()) return false;
+
+    outActions.resize(outFrame.ActionCount);
+    if (actionBytes) std::memcpy(outActions.data(), m_Data.data() + m_Cursor, actionBytes);
+    m_Cursor += actionBytes;
+    m_FrameIndex++;
+    return true;
+}
+
+// =============================================================================
+//  StageTimings
+// =============================================================================
+
+void StageTimings::BeginFrame()
+{
+    m_Stride   = m_Stages.size() + m_Counters.size();
+    m_RowStart = m_Rows.size();
+    m_Rows.resize(m_RowStart + m_Stride, 0.0f);
+    m_Last = Clock::now();
+}
+
+void StageTimings::EndStage(uint32_t stage)
+{
+    Clock::time_point now = Clock::now();
+    m_Rows[m_RowStart + stage] += std::chrono::duration<float, std::milli>(now - m_Last).count();
+    m_Last = now;
+}
+
+void StageTimings::SetCounter(uint32_t counter, float value)
+{
+    m_Rows[m_RowStart + m_Stages.size() + counter] = value;
+}
+
+float StageTimings::GetMeanMs(uint32_t stage) const
+{
+    const uint32_t frames = GetFrameCount();
+    if (frames == 0) return 0.0f;
+
+    double sum = 0.0;
+    for (uint32_t f = 0; f < frames; f++) sum += m_Rows[f * m_Stride + stage];
+    return (float)(sum / frames);
+}
+
+bool StageTimings::WriteCsv(const std::string& path) const
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) return false;
+
+    out << "frame";
+    for (const char* name : m_Stages)   out << ',' << name << "_ms";
+    out << ",total_ms";
+    for (const char* name : m_Counters) out << ',' << name;
+    out << '\n';
+
+    const uint32_t frames = GetFrameCount();
+    for (uint32_t f = 0; f < frames; f++)
+    {
+        const float* row = m_Rows.data() + f * m_Stride;
+        float total = 0.0f;
+        out << f;
+        for (size_t s = 0; s < m_Stages.size(); s++) { out << ',' << row[s]; total += row[s]; }
+        out << ',' << total;
+        for (size_t c = 0; c < m_Counters.size(); c++) out << ',' << row[m_Stages.size() + c];
+        out << '\n';
+    }
+    return (bool)out;
+}
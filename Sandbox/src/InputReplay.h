@@ -0,0 +1,124 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <utility>
+#include <cstdint>
+
+// --- INPUT REPLAY ---
+// Records everything MainGameLayer reads from the player on each frame. That
+// covers the frame time, the camera orientation after mouse and arrow-key
+// input, the held gameplay buttons, and the discrete actions raised by events
+// since the last frame. A Fire action also carries the shot ray as aimed when it
+// was raised, because the camera can move between the event and the end of the
+// frame. Played back with the same seed and tick rate, the fixed-step
+// simulation goes through the same ticks with the same inputs.
+//
+// File layout: Header | (InputFrame, InputAction x ActionCount) x FrameCount
+
+enum class InputMode { Live, Record, Replay };
+
+enum InputButton : uint16_t {
+    InputButton_MoveForward = 1 << 0,
+    InputButton_MoveBack    = 1 << 1,
+    InputButton_MoveLeft    = 1 << 2,
+    InputButton_MoveRight   = 1 << 3,
+    InputButton_Reload      = 1 << 4,
+    InputButton_Respawn     = 1 << 5,
+};
+
+enum class InputActionType : uint8_t {
+    TogglePerspective,
+    EnterFirstPerson,
+    ExitFirstPerson,
+    Fire,
+};
+
+struct InputAction {
+    InputActionType Type;
+    uint8_t         Reserved[3];
+    float           Origin[3];      // Fire only: world-space shot ray
+    float           Direction[3];   // Fire only: normalized
+};
+
+struct InputFrame {
+    float    Dt;
+    float    CameraYaw;
+    float    CameraPitch;
+    float    CameraDistance;
+    uint16_t Buttons;       // InputButton bits
+    uint16_t ActionCount;   // InputAction records following this frame
+};
+
+// Tick rates a recording may carry; also the range of the Sim Tick Rate slider.
+constexpr uint32_t k_MinSimTickRate = 15;
+constexpr uint32_t k_MaxSimTickRate = 120;
+
+class InputRecorder
+{
+public:
+    ~InputRecorder() { Close(); }
+
+    bool Open(const std::string& path, uint32_t seed, uint32_t tickRate);
+    void Write(const InputFrame& frame, const std::vector<InputAction>& actions);
+    void Close();
+
+    bool     IsOpen()        const { return m_Out.is_open(); }
+    uint32_t GetFrameCount() const { return m_FrameCount; }
+
+private:
+    std::ofstream m_Out;
+    uint32_t      m_FrameCount = 0;
+};
+
+class InputPlayback
+{
+public:
+    // Rejects bad headers and tick rates outside [k_MinSimTickRate, k_MaxSimTickRate]. The frame
+    // count is taken from the complete frames in the file, so a recording cut short still plays.
+    bool Open(const std::string& path);
+    bool Next(InputFrame& outFrame, std::vector<InputAction>& outActions);
+
+    uint32_t GetSeed()       const { return m_Seed; }
+    uint32_t GetTickRate()   const { return m_TickRate; }
+    uint32_t GetFrameCount() const { return m_FrameCount; }
+    uint32_t GetFrameIndex() const { return m_FrameIndex; }
+
+private:
+    std::vector<uint8_t> m_Data;
+    size_t   m_Cursor     = 0;
+    uint32_t m_Seed       = 0;
+    uint32_t m_TickRate   = 0;
+    uint32_t m_FrameCount = 0;
+    uint32_t m_FrameIndex = 0;
+};
+
+// Wall-clock time per named stage of a frame, one row per frame, written out as CSV.
+class StageTimings
+{
+public:
+    StageTimings(std::vector<const char*> stages, std::vector<const char*> counters)
+        : m_Stages(std::move(stages)), m_Counters(std::move(counters)) {}
+
+    void BeginFrame();
+    void EndStage(uint32_t stage);                    // time since BeginFrame or the previous EndStage
+    void SetCounter(uint32_t counter, float value);
+
+    uint32_t GetFrameCount() const { return m_Stride ? (uint32_t)(m_Rows.size() / m_Stride) : 0; }
+    float    GetMeanMs(uint32_t stage) const;
+    const char* GetStageName(uint32_t stage) const { return m_Stages[stage]; }
+    uint32_t GetStageCount() const { return (uint32_t)m_Stages.size(); }
+
+    bool WriteCsv(const std::string& path) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<const char*> m_Stages;
+    std::vector<const char*> m_Counters;
+    std::vector<float>       m_Rows;   // stages then counters, per frame
+    size_t                   m_Stride = 0;
+    size_t                   m_RowStart = 0;
+    Clock::time_point        m_Last;
+};
@@ -2,24 +2,98 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <cstdlib>
+#include <cstdio>
 #include <algorithm>
-#include <set>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <filesystem>
 #include <imgui.h>
 
-MainGameLayer::MainGameLayer()
-    : Layer("Main Game"), m_Camera(45.0f, 1.778f, 0.1f, 1000.0f)
+// Writes a transform and only flags it dirty when a value actually changed, so
+// Scene::Update can skip world-matrix rebuilds for subtrees that stayed put.
+static void AssignTransform(Aether::TransformComponent& t, const glm::vec3& translation,
+                            const glm::quat& rotation, const glm::vec3& scale)
+{
+    if (t.Translation == translation && t.Rotation == rotation && t.Scale == scale) return;
+    t.Translation = translation;
+    t.Rotation    = rotation;
+    t.Scale       = scale;
+    t.Dirty       = true;
+}
+
+MainGameLayer::MainGameLayer(InputMode inputMode, const std::string& inputPath)
+    : Layer("Main Game"), m_Camera(45.0f, 1.778f, 0.1f, 1000.0f), m_InputMode(inputMode), m_InputPath(inputPath)
 {
     m_Camera.SetDistance(6.0f);
 }
 
 void MainGameLayer::Attach()
 {
-    std::ifstream in("save.dat", std::ios::binary);
-    if (in) {
-        in.read((char*)&m_HighScore, sizeof(m_HighScore));
-        in.read((char*)&m_ZombiesKilled, sizeof(m_ZombiesKilled)); // Đọc thêm biến này
+    m_AttachStart = std::chrono::steady_clock::now();
+    if (const char* serial = std::getenv("TLE_SERIAL_LOAD")) m_SerialLoad = serial[0] == '1';
+
+    // Recorded and replayed sessions start from a fresh world so the same inputs reach the same state.
+    if (m_InputMode == InputMode::Replay) {
+        if (m_InputPlayback.Open(m_InputPath)) {
+            m_SimSeed     = m_InputPlayback.GetSeed();
+            m_SimTickRate = (int)m_InputPlayback.GetTickRate();
+            AE_INFO("Replaying {0} ({1} frames, {2} Hz)", m_InputPath, m_InputPlayback.GetFrameCount(), m_SimTickRate);
+        } else {
+            AE_ERROR("Could not open input recording {0}", m_InputPath);
+            m_InputMode = InputMode::Live;
+        }
+    }
+    else if (m_InputMode == InputMode::Record) {
+        if (m_InputRecorder.Open(m_InputPath, m_SimSeed, (uint32_t)m_SimTickRate)) {
+            AE_INFO("Recording input to {0}", m_InputPath);
+        } else {
+            AE_ERROR("Could not create input recording {0}", m_InputPath);
+            m_InputMode = InputMode::Live;
+        }
+    }
+    m_SaveOnExit = m_InputMode == InputMode::Live;
+    m_SimRng.seed(m_SimSeed);
+
+    Profiler::SetThreadName("Main");
+    if (m_InputMode == InputMode::Replay) Profiler::SetEnabled(true);
+    PROFILE_ZONE("MainGameLayer::Attach");
+
+    // Map the save file on a worker while the assets below load; applied at the end of Attach.
+    if (m_SaveOnExit) {
+        m_PendingLoad = std::async(std::launch::async, []() {
+            PROFILE_ZONE("Snapshot::Open");
+            Snapshot::File file;
+            file.Open("save.dat");
+            return file;
+        });
     }
 
+    // glTF parsing needs no GL context, so the models decode on a worker while the shaders,
+    // textures and sounds below load here. Aether::Importer::Import makes no promise that it
+    // is safe to call from several threads at once, so a single worker imports the models
+    // one after another, in the order loadModel asks for them. loadModel uploads each one on
+    // this thread as soon as its import is done. With TLE_SERIAL_LOAD the worker is deferred
+    // and the first loadModel runs it here.
+    using ImportResult = decltype(Aether::Importer::Import(""));
+    enum ModelSlot { Model_Map, Model_Player, Model_Zombie, Model_Gun, Model_Count };
+    static const char* const modelPaths[Model_Count] = {
+        "Assets/models/map.glb", "Assets/models/humanv2.glb",
+        "Assets/models/zombie.glb", "Assets/models/gun.glb"
+    };
+    std::promise<ImportResult> importDone[Model_Count];
+    std::future<ImportResult>  imports[Model_Count];
+    for (int i = 0; i < Model_Count; i++) imports[i] = importDone[i].get_future();
+
+    const auto importLaunch = m_SerialLoad ? std::launch::deferred : std::launch::async;
+    std::future<void> importWorker = std::async(importLaunch, [&importDone]() {
+        for (int i = 0; i < Model_Count; i++) {
+            PROFILE_ZONE("Importer::Import");
+            try   { importDone[i].set_value(Aether::Importer::Import(modelPaths[i])); }
+            catch (...) { importDone[i].set_exception(std::current_exception()); }
+        }
+    });
+
     m_ZombiesKilled = 0;
 
     ImGuiContext* ctx = Aether::ImGuiLayer::GetContext();
@@ -94,8 +168,29 @@ void MainGameLayer::Attach()
     sunTransform.Translation = glm::vec3(0.0f, 50.0f, 0.0f);
     sunTransform.Dirty       = true;
 
+    // Time spent blocked on the import and the GPU upload, per model. With serial loading the
+    // map's wait holds all four parses; otherwise it is whatever the worker has not finished yet.
+    float importMs = 0.0f, uploadMs = 0.0f;
+    auto loadModel = [&](ModelSlot slot) {
+        PROFILE_ZONE("LoadModel");
+        const char* path = modelPaths[slot];
+        auto start = std::chrono::steady_clock::now();
+        if (m_SerialLoad && importWorker.valid()) importWorker.get();
+        auto imported = imports[slot].get();
+        auto parsed   = std::chrono::steady_clock::now();
+        auto uploaded = Aether::Importer::Upload(std::move(imported));
+        auto done     = std::chrono::steady_clock::now();
+
+        float waitMs = std::chrono::duration<float, std::milli>(parsed - start).count();
+        float gpuMs  = std::chrono::duration<float, std::milli>(done - parsed).count();
+        importMs += waitMs;
+        uploadMs += gpuMs;
+        AE_INFO("Loaded {0}: import wait {1:.2f} ms, upload {2:.2f} ms", path, waitMs, gpuMs);
+        return uploaded;
+    };
+
     // --- MAP ---
-    auto uploadMap = Aether::Importer::Upload(Aether::Importer::Import("Assets/models/map.glb"));
+    auto uploadMap = loadModel(Model_Map);
     if (!uploadMap.meshIDs.empty()) {
         m_BaseMapMesh = Aether::AssetManager::GetHandle(uploadMap.meshIDs[0]);
         if (uploadMap.matIDs.empty()) AE_ERROR("no material!");
@@ -111,7 +206,7 @@ void MainGameLayer::Attach()
     pTransform.Rotation      = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
     pTransform.Dirty         = true;
 
-    auto uploadPlayer = Aether::Importer::Upload(Aether::Importer::Import("Assets/models/humanv2.glb"));
+    auto uploadPlayer = loadModel(Model_Player);
     m_Scene.LoadHierarchy(uploadPlayer, m_Player);
 
     if (!uploadPlayer.animatorIDS.empty())
@@ -139,7 +234,7 @@ void MainGameLayer::Attach()
         m_Scene.AddComponent<Aether::ColliderComponent>(m_Player, bodyID);
     }
 
-    m_ZombieSceneData = Aether::Importer::Upload(Aether::Importer::Import("Assets/models/zombie.glb"));
+    m_ZombieSceneData = loadModel(Model_Zombie);
     if (!m_ZombieSceneData.animatorIDS.empty())
         m_ZombieRunAnimation = m_ZombieSceneData.animatorIDS[0];
 
@@ -150,7 +245,7 @@ void MainGameLayer::Attach()
     gTransform.Scale       = { 1.0f, 1.0f, 1.0f };
     gTransform.Dirty       = true;
 
-    auto uploadGun = Aether::Importer::Upload(Aether::Importer::Import("Assets/models/gun.glb"));
+    auto uploadGun = loadModel(Model_Gun);
     m_Scene.LoadHierarchy(uploadGun, m_Gun);
 
     if (!uploadGun.animatorIDS.empty()) {
@@ -165,101 +260,431 @@ void MainGameLayer::Attach()
 
     Aether::PhysicsSystem::SetGravity({ 0.0f, 0.0f, 0.0f });
 
-    Aether::AssetManager::CreateAsset<Aether::Sound>(m_BgmSoundID,   "Assets/audio/Hatsune Miku - Ievan Polkka.mp3");
-    Aether::AssetManager::CreateAsset<Aether::Sound>(m_GunSoundID,   "Assets/audio/pistol.mp3");
-    Aether::AssetManager::CreateAsset<Aether::Sound>(m_GunReloadID,  "Assets/audio/pistol_reload.mp3");
-    Aether::AssetManager::CreateAsset<Aether::Sound>(m_ZombieBiteID, "Assets/audio/zombie_bite.mp3");
+    // Load time per sound, so the cost of the fully decoded BGM stays visible in the log.
+    auto loadSound = [](Aether::UUID& id, const char* path) {
+        auto start = std::chrono::steady_clock::now();
+        Aether::AssetManager::CreateAsset<Aether::Sound>(id, path);
+        float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        AE_INFO("Loaded {0} in {1:.2f} ms", path, ms);
+    };
+    loadSound(m_BgmSoundID,    "Assets/audio/Hatsune Miku - Ievan Polkka.mp3");
+    loadSound(m_GunSoundID,    "Assets/audio/pistol.mp3");
+    loadSound(m_GunReloadID,   "Assets/audio/pistol_reload.mp3");
+    loadSound(m_ZombieBiteID,  "Assets/audio/zombie_bite.mp3");
+
+    // One-shot SFX voices: bites outrank reloads, reloads outrank gunshots.
+    m_Voices.Reserve(m_GunSoundID,   8, 0);
+    m_Voices.Reserve(m_GunReloadID,  2, 1);
+    m_Voices.Reserve(m_ZombieBiteID, 2, 2);
+
+    // The groan clip ships with the assets; an older asset checkout without it just runs without crowd audio.
+    if (std::filesystem::exists(k_ZombieGroanPath)) {
+        loadSound(m_ZombieGroanID, k_ZombieGroanPath);
+        m_CrowdAudio.Init(m_ZombieGroanID, m_Voices);
+    } else {
+        AE_INFO("Crowd audio disabled: {0} not found", k_ZombieGroanPath);
+    }
 
     Aether::UUID bgmSrcID;
     Aether::AudioSystem::CreateSource(bgmSrcID, m_BgmSoundID, Aether::AudioType::Audio2D);
     Aether::AudioSystem::SetLooping(bgmSrcID, true);
     Aether::AudioSystem::Play(bgmSrcID);
 
-    AE_INFO("MainGameLayer started.");
+    if (m_PendingLoad.valid()) {
+        auto start = std::chrono::steady_clock::now();
+        Snapshot::File save = m_PendingLoad.get();
+        if (save.IsLegacy()) {
+            uint32_t lastKills = 0;
+            save.ReadLegacy(m_HighScore, lastKills);
+        }
+        else if (save.IsOpen()) {
+            ApplySnapshot(save);
+        }
+        float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        AE_INFO("Save restored in {0:.2f} ms ({1} bytes)", ms, save.Size());
+    }
+    SyncSimPoses();
+
+    float attachMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_AttachStart).count();
+    AE_INFO("MainGameLayer started in {0:.1f} ms, {1} model import (import wait {2:.1f} ms, upload {3:.1f} ms)",
+            attachMs, m_SerialLoad ? "serial" : "background", importMs, uploadMs);
 }
 
 void MainGameLayer::Detach()
 {
-    std::ofstream out("save.dat", std::ios::binary);
-    if (out)
-    {
-        out.write((char*)&m_HighScore, sizeof(m_HighScore));
-        out.write((char*)&m_ZombiesKilled, sizeof(m_ZombiesKilled)); // Lưu thêm biến này
+    // Capture before anything below tears the world down; the write itself must land before we return.
+    if (m_SaveOnExit)
+        SaveSnapshotAsync();
+    if (m_PendingSave.valid()) m_PendingSave.wait();
+
+    if (m_InputMode == InputMode::Record) {
+        AE_INFO("Recorded {0} frames to {1}", m_InputRecorder.GetFrameCount(), m_InputPath);
+        m_InputRecorder.Close();
+    }
+    else if (m_InputMode == InputMode::Replay) {
+        FinishReplay();
     }
-
 
     auto rigSystem = Aether::AnimationSystem::GetModule<Aether::RigModule>();
 
-    for (auto& [entity, record] : m_ZombieRegistry) {
+    for (uint32_t i = 0; i < m_Zombies.Size(); i++) {
+        Aether::Entity entity = m_Zombies.EntityAt(i);
+        auto&          record = m_Zombies.At(i);
         if (rigSystem) rigSystem->DestroyAnimator(record.animatorID);
         Aether::PhysicsSystem::DestroyBody(record.bodyID);
         if (m_Scene.IsValid(entity)) m_Scene.DestroyHierarchy(entity);
     }
-    m_ZombieRegistry.clear();
-    m_ActiveZombies.clear();
+    m_Zombies.Clear();
 
     if (m_PlayerBodyID != 0)
         Aether::PhysicsSystem::DestroyBody(m_PlayerBodyID);
 
     m_ShadowShader.reset();
     m_MainShader.reset();
+    m_UniformsApplied = false;
     m_ActiveChunks.clear();
 
+    const bool groanLoaded = m_CrowdAudio.IsActive();
+    m_CrowdAudio.Shutdown();
+    m_Voices.Clear();
     Aether::AssetManager::Unload(m_BgmSoundID);
     Aether::AssetManager::Unload(m_GunSoundID);
     Aether::AssetManager::Unload(m_GunReloadID);
     Aether::AssetManager::Unload(m_ZombieBiteID);
+    if (groanLoaded) Aether::AssetManager::Unload(m_ZombieGroanID);
 }
 
 void MainGameLayer::Update(Aether::Timestep ts)
 {
+    InputFrame replayFrame {};
+    if (m_InputMode == InputMode::Replay && !m_InputPlayback.Next(replayFrame, m_FrameActions))
+        FinishReplay();
+
+    const bool timed = m_InputMode == InputMode::Replay;
+    if (timed) m_StageTimings.BeginFrame();
+    auto endStage = [&](uint32_t stage) { if (timed) m_StageTimings.EndStage(stage); };
+
+    Profiler::MarkFrame();
+    AllocTracker::EndFrame();
+    m_ZombieEmittersValid = false;
+
+    if (m_FirstFrame) {
+        m_FirstFrame = false;
+        float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_AttachStart).count();
+        AE_INFO("Time to first frame: {0:.1f} ms ({1} model import)", ms, m_SerialLoad ? "serial" : "background");
+    }
+    PROFILE_ZONE("MainGameLayer::Update");
+
     auto& window = Aether::Application::Get().GetWindow();
     m_Camera.SetViewportSize((float)window.GetWidth(), (float)window.GetHeight());
-    auto rigSystem = Aether::AnimationSystem::GetModule<Aether::RigModule>();
 
-    m_Camera.Update(ts);
-
-    float rotationSpeed = 2.0f; // Tốc độ xoay
-    if (Aether::Input::IsKeyPressed(Aether::Key::Left))
+    // --- INPUT ---
+    if (m_InputMode == InputMode::Replay)
     {
-        // Xoay sang trái
-        m_Camera.SetYaw(m_Camera.GetYaw() - rotationSpeed * ts);
+        // Recorded frame time, not wall time, so the fixed-step loop runs the same ticks.
+        ts = Aether::Timestep(replayFrame.Dt);
+        for (const InputAction& action : m_FrameActions)
+            HandleAction(action);
+        m_Camera.SetYaw(replayFrame.CameraYaw);
+        m_Camera.SetPitch(replayFrame.CameraPitch);
+        m_Camera.SetDistance(replayFrame.CameraDistance);
+        m_FrameButtons = replayFrame.Buttons;
     }
-    if (Aether::Input::IsKeyPressed(Aether::Key::Right))
+    else
     {
-        // Xoay sang phải
-        m_Camera.SetYaw(m_Camera.GetYaw() + rotationSpeed * ts);
+        m_Camera.Update(ts);
+
+        float rotationSpeed = 2.0f; // Tốc độ xoay
+        if (Aether::Input::IsKeyPressed(Aether::Key::Left))
+        {
+            // Xoay sang trái
+            m_Camera.SetYaw(m_Camera.GetYaw() - rotationSpeed * ts);
+        }
+        if (Aether::Input::IsKeyPressed(Aether::Key::Right))
+        {
+            // Xoay sang phải
+            m_Camera.SetYaw(m_Camera.GetYaw() + rotationSpeed * ts);
+        }
+
+        m_FrameButtons = SampleButtons();
+        if (m_InputMode == InputMode::Record)
+            m_InputRecorder.Write({ (float)ts, m_Camera.GetYaw(), m_Camera.GetPitch(), m_Camera.GetDistance(),
+                                    m_FrameButtons, 0 }, m_FrameActions);
     }
+    m_FrameActions.clear();
 
     float camDistance           = m_Camera.GetDistance();
     m_CurrentRenderDistance     = m_BaseRenderDistance + static_cast<int>(camDistance / m_ZoomInfluence);
     m_CurrentRenderDistance     = std::clamp(m_CurrentRenderDistance, 1, 30);
+    endStage(Stage_Input);
+
+    // --- FIXED-STEP SIMULATION ---
+    // Gameplay advances in whole ticks of 1/m_SimTickRate; whatever is left over
+    // becomes the blend factor between the last two ticks for display.
+    const float   simStep = 1.0f / (float)m_SimTickRate;
+    const SimInput input  = SampleSimInput(m_FrameButtons);
+
+    m_SimAccumulator = std::min(m_SimAccumulator + (float)ts, k_MaxSimBacklog);
+    m_SimTicksThisFrame = 0;
+    if (m_SimAccumulator >= simStep)
+        RestoreSimPoses();
+    while (m_SimAccumulator >= simStep)
+    {
+        PROFILE_ZONE("SimulationTick");
+        SimulationTick(input, simStep);
+        m_SimAccumulator -= simStep;
+        m_SimTicksThisFrame++;
+    }
+    endStage(Stage_Simulation);
+    {
+        PROFILE_ZONE("Interpolate");
+        InterpolateSimPoses(m_SimAccumulator / simStep);
+    }
 
     if (m_Scene.IsValid(m_Player))
     {
         auto& pTransform = m_Scene.GetComponent<Aether::TransformComponent>(m_Player);
 
-        glm::vec3 camForward = m_Camera.GetForwardDirection();
-        glm::vec3 camRight   = m_Camera.GetRightDirection();
         static float s_HeadBobTimer      = 0.0f;
         static float s_BobAmplitudeBlend = 0.0f;
 
-        camForward.y = 0.0f; camRight.y = 0.0f;
-        if (glm::length(camForward) > 0.0f) camForward = glm::normalize(camForward);
-        if (glm::length(camRight)   > 0.0f) camRight   = glm::normalize(camRight);
+        if (glm::length(input.moveDir) > 0.0f && !m_FirstPerson && m_InputMode != InputMode::Replay)
+            m_Camera.Update(ts);
+
+        if (m_IsPlayerMoving) {
+            s_HeadBobTimer       += (float)ts * m_bobSpeed;
+            s_BobAmplitudeBlend   = glm::mix(s_BobAmplitudeBlend, 1.0f, (float)ts * 10.0f);
+        } else {
+            s_BobAmplitudeBlend   = glm::mix(s_BobAmplitudeBlend, 0.0f, (float)ts * 10.0f);
+            if (s_BobAmplitudeBlend < 0.01f) {
+                s_BobAmplitudeBlend = 0.0f;
+                s_HeadBobTimer      = 0.0f;
+            }
+        }
+
+        float targetAmplitude = m_FirstPerson ? m_bobStrength : m_bobStrength / 2.0f;
+        float bobOffsetY      = glm::abs(glm::sin(s_HeadBobTimer)) * targetAmplitude * s_BobAmplitudeBlend;
+
+        glm::vec3 playerTopPos = pTransform.Translation + glm::vec3(0.0f, 1.0f + bobOffsetY, 0.0f);
+        glm::vec3 playerEyePos = pTransform.Translation + glm::vec3(0.0f, 1.7f + bobOffsetY, 0.0f);
+
+        if (m_FirstPerson)
+        {
+            m_Camera.SetDistance(0.0f);
+            m_Camera.SetFocalPoint(playerEyePos);
+        }
+        else
+        {
+            glm::vec3 shoulderOffset  = m_Camera.GetRightDirection() * 0.5f;
+            glm::vec3 stablePlayerPos = pTransform.Translation + glm::vec3(0.0f, 1.5f, 0.0f);
+            m_Camera.SetFocalPoint(stablePlayerPos + shoulderOffset);
 
-        glm::vec3 moveDir(0.0f);
-        if (m_PlayerHealth > 0.0f)
+            if (m_LockCamera) {
+                m_Camera.SetDistance(5.0f);
+                if (m_Camera.GetPitch() < 0.2f) m_Camera.SetPitch(0.2f);
+            }
+        }
+
+        if (m_Scene.IsValid(m_SunLight)) {
+            auto& lightTransform = m_Scene.GetComponent<Aether::TransformComponent>(m_SunLight);
+            AssignTransform(lightTransform, playerTopPos + glm::vec3(0.0f, 50.0f, 0.0f),
+                            lightTransform.Rotation, lightTransform.Scale);
+            m_Scene.GetComponent<Aether::LightComponent>(m_SunLight).Config.castShadows = true;
+        }
+    }
+
+    // --- SHADER UNIFORMS ---
+    ApplyMainShaderUniforms();
+
+    // --- GUN POSITIONING ---
+    if (m_Scene.IsValid(m_Gun) && m_Scene.IsValid(m_Player))
+    {
+        auto& pTransform = m_Scene.GetComponent<Aether::TransformComponent>(m_Player);
+        auto& gTransform = m_Scene.GetComponent<Aether::TransformComponent>(m_Gun);
+
+        if (m_FirstPerson)
         {
-            if (Aether::Input::IsKeyPressed(Aether::Key::W)) moveDir += camForward;
-            if (Aether::Input::IsKeyPressed(Aether::Key::S)) moveDir -= camForward;
-            if (Aether::Input::IsKeyPressed(Aether::Key::A)) moveDir -= camRight;
-            if (Aether::Input::IsKeyPressed(Aether::Key::D)) moveDir += camRight;
+            glm::vec3 camPos  = m_Camera.GetPosition();
+            glm::vec3 forward = m_Camera.GetForwardDirection();
+            glm::vec3 right   = m_Camera.GetRightDirection();
+            glm::vec3 up      = m_Camera.GetUpDirection();
+
+            glm::quat camQuat = glm::quat(glm::vec3(-m_Camera.GetPitch(), -m_Camera.GetYaw(), 0.0f));
+            AssignTransform(gTransform,
+                            camPos + (right * m_GunPosFP.x) + (up * m_GunPosFP.y) + (forward * m_GunPosFP.z),
+                            camQuat * glm::quat(glm::radians(m_GunRotFP)),
+                            m_GunScaleFP);
         }
         else
         {
-            pTransform.Translation.y = yFloor;
+            glm::quat pRot    = pTransform.Rotation;
+            glm::vec3 forward = pRot * glm::vec3(0.0f, 0.0f, -1.0f);
+            glm::vec3 right   = pRot * glm::vec3(1.0f, 0.0f,  0.0f);
+            glm::vec3 up      = pRot * glm::vec3(0.0f, 1.0f,  0.0f);
+
+            AssignTransform(gTransform,
+                            pTransform.Translation + (right * m_GunPosTP.x) + (up * m_GunPosTP.y) + (forward * m_GunPosTP.z),
+                            pRot * glm::quat(glm::radians(m_GunRotTP)),
+                            m_GunScaleTP);
         }
+    }
+
+    endStage(Stage_Present);
+
+    {
+        ALLOC_SCOPE(AllocTag::Audio);
+        Aether::AudioSystem::SetListener(m_Camera.GetPosition(), m_Camera.GetForwardDirection(),
+                                         m_Camera.GetUpDirection());
+        m_Voices.Update();
+    }
+
+    // --- CROWD AUDIO ---
+    if (m_CrowdAudio.IsActive())
+    {
+        PROFILE_ZONE("Crowd Audio");
+        ALLOC_SCOPE(AllocTag::Crowd);
+        m_CrowdAudio.Update((float)ts, m_Camera.GetPosition(), GatherZombiePositions());
+    }
+    endStage(Stage_Audio);
+
+    {
+        PROFILE_ZONE("Scene::Update");
+        ALLOC_SCOPE(AllocTag::Scene);
+        m_Scene.Update(ts, &m_Camera);
+    }
+    endStage(Stage_Scene);
+
+    if (timed) {
+        m_StageTimings.SetCounter(Counter_SimTicks, (float)m_SimTicksThisFrame);
+        m_StageTimings.SetCounter(Counter_Zombies,  (float)m_Zombies.Size());
+        m_StageTimings.SetCounter(Counter_Chunks,   (float)m_ActiveChunks.size());
+        m_StageTimings.SetCounter(Counter_Allocs,   (float)AllocTracker::GetFrameAllocs());
+    }
+
+    m_FrameArena.Reset();
+}
+
+// =============================================================================
+//  Fixed-step simulation
+// =============================================================================
+
+uint16_t MainGameLayer::SampleButtons() const
+{
+    uint16_t buttons = 0;
+    if (Aether::Input::IsKeyPressed(Aether::Key::W)) buttons |= InputButton_MoveForward;
+    if (Aether::Input::IsKeyPressed(Aether::Key::S)) buttons |= InputButton_MoveBack;
+    if (Aether::Input::IsKeyPressed(Aether::Key::A)) buttons |= InputButton_MoveLeft;
+    if (Aether::Input::IsKeyPressed(Aether::Key::D)) buttons |= InputButton_MoveRight;
+    if (Aether::Input::IsKeyPressed(Aether::Key::R)) buttons |= InputButton_Reload;
+    if (Aether::Input::IsKeyPressed(Aether::Key::Space) ||
+        Aether::Input::IsMouseButtonPressed(Aether::Mouse::ButtonLeft))
+        buttons |= InputButton_Respawn;
+    return buttons;
+}
+
+MainGameLayer::SimInput MainGameLayer::SampleSimInput(uint16_t buttons) const
+{
+    SimInput input;
+    input.cameraYaw = m_Camera.GetYaw();
+
+    if (m_PlayerHealth > 0.0f)
+    {
+        glm::vec3 camForward = m_Camera.GetForwardDirection();
+        glm::vec3 camRight   = m_Camera.GetRightDirection();
+        camForward.y = 0.0f; camRight.y = 0.0f;
+        if (glm::length(camForward) > 0.0f) camForward = glm::normalize(camForward);
+        if (glm::length(camRight)   > 0.0f) camRight   = glm::normalize(camRight);
+
+        if (buttons & InputButton_MoveForward) input.moveDir += camForward;
+        if (buttons & InputButton_MoveBack)    input.moveDir -= camForward;
+        if (buttons & InputButton_MoveLeft)    input.moveDir -= camRight;
+        if (buttons & InputButton_MoveRight)   input.moveDir += camRight;
+    }
+
+    input.reload  = (buttons & InputButton_Reload)  != 0;
+    input.respawn = (buttons & InputButton_Respawn) != 0;
+    return input;
+}
+
+// Transforms hold interpolated poses between frames; put the authoritative ones back before ticking.
+void MainGameLayer::RestoreSimPoses()
+{
+    if (m_Scene.IsValid(m_Player)) {
+        auto& t = m_Scene.GetComponent<Aether::TransformComponent>(m_Player);
+        AssignTransform(t, m_PlayerPose.position, m_PlayerPose.rotation, t.Scale);
+    }
+    for (uint32_t i = 0; i < m_Zombies.Size(); i++) {
+        Aether::Entity zombie = m_Zombies.EntityAt(i);
+        if (!m_Scene.IsValid(zombie)) continue;
+        auto& t   = m_Scene.GetComponent<Aether::TransformComponent>(zombie);
+        auto& rec = m_Zombies.At(i);
+        AssignTransform(t, rec.pose.position, rec.pose.rotation, t.Scale);
+    }
+}
+
+// Adopts whatever the transforms currently hold as both sim poses, e.g. after loading a save.
+void MainGameLayer::SyncSimPoses()
+{
+    if (m_Scene.IsValid(m_Player)) {
+        auto& t = m_Scene.GetComponent<Aether::TransformComponent>(m_Player);
+        m_PlayerPose     = { t.Translation, t.Rotation };
+        m_PlayerPrevPose = m_PlayerPose;
+    }
+    for (uint32_t i = 0; i < m_Zombies.Size(); i++) {
+        Aether::Entity zombie = m_Zombies.EntityAt(i);
+        if (!m_Scene.IsValid(zombie)) continue;
+        auto& t   = m_Scene.GetComponent<Aether::TransformComponent>(zombie);
+        auto& rec = m_Zombies.At(i);
+        rec.pose     = { t.Translation, t.Rotation };
+        rec.prevPose = rec.pose;
+    }
+}
+
+void MainGameLayer::InterpolateSimPoses(float alpha)
+{
+    auto blend = [alpha](const SimPose& a, const SimPose& b) {
+        glm::quat to = glm::dot(a.rotation, b.rotation) < 0.0f ? -b.rotation : b.rotation;
+        return SimPose{ glm::mix(a.position, b.position, alpha), glm::normalize(glm::slerp(a.rotation, to, alpha)) };
+    };
+
+    if (m_Scene.IsValid(m_Player)) {
+        auto&   t    = m_Scene.GetComponent<Aether::TransformComponent>(m_Player);
+        SimPose pose = blend(m_PlayerPrevPose, m_PlayerPose);
+        AssignTransform(t, pose.position, pose.rotation, m_FirstPerson ? glm::vec3(0.001f) : glm::vec3(1.0f));
+    }
+    for (uint32_t i = 0; i < m_Zombies.Size(); i++) {
+        Aether::Entity zombie = m_Zombies.EntityAt(i);
+        if (!m_Scene.IsValid(zombie)) continue;
+        auto&   t    = m_Scene.GetComponent<Aether::TransformComponent>(zombie);
+        auto&   rec  = m_Zombies.At(i);
+        SimPose pose = blend(rec.prevPose, rec.pose);
+        AssignTransform(t, pose.position, pose.rotation, t.Scale);
+    }
+}
+
+// One gameplay step. Only reads state that is itself advanced here plus the sampled input,
+// so the same seed and input sequence reproduce the same positions.
+void MainGameLayer::SimulationTick(const SimInput& input, float dt)
+{
+    auto rigSystem = Aether::AnimationSystem::GetModule<Aether::RigModule>();
+
+    m_PlayerPrevPose = m_PlayerPose;
+    for (uint32_t i = 0; i < m_Zombies.Size(); i++) m_Zombies.At(i).prevPose = m_Zombies.At(i).pose;
+
+    m_SimTime += dt;
+    m_SimTick++;
+
+    // Shots queued since the last tick hit zombies where the simulation has them, not where
+    // they were last drawn, so kills do not depend on frame time.
+    ResolveShots();
+
+    if (m_Scene.IsValid(m_Player))
+    {
+        auto& pTransform = m_Scene.GetComponent<Aether::TransformComponent>(m_Player);
+
+        glm::vec3 moveDir = input.moveDir;
+        if (m_PlayerHealth <= 0.0f)
+            pTransform.Translation.y = yFloor;
 
         bool isMoving = glm::length(moveDir) > 0.0f;
 
@@ -267,7 +692,7 @@ void MainGameLayer::Update(Aether::Timestep ts)
         {
             moveDir         = glm::normalize(moveDir);
             float speedMult = GetSpeedMultiplier(pTransform.Translation);
-            float stepLen   = m_PlayerSpeed * speedMult * (float)ts;
+            float stepLen   = m_PlayerSpeed * speedMult * dt;
 
             auto tryMove = [&](glm::vec3 delta) -> bool {
                 glm::vec3 candidate = pTransform.Translation + delta;
@@ -286,86 +711,42 @@ void MainGameLayer::Update(Aether::Timestep ts)
                 float     targetAngle = glm::atan(moveDir.x, moveDir.z);
                 glm::quat targetRot   = glm::quat(glm::vec3(0.0f, targetAngle, 0.0f));
                 if (glm::dot(pTransform.Rotation, targetRot) < 0.0f) targetRot = -targetRot;
-                float blend = 1.0f - glm::exp(-15.0f * (float)ts);
+                float blend = 1.0f - glm::exp(-15.0f * dt);
                 pTransform.Rotation = glm::normalize(glm::slerp(pTransform.Rotation, targetRot, blend));
-                m_Camera.Update(ts);
             }
 
-            pTransform.Dirty = true;
-
             if (didMove != m_IsPlayerMoving) {
                 if (didMove) rigSystem->Play(m_RunAnimation);
                 else         rigSystem->Pause(m_RunAnimation);
                 m_IsPlayerMoving = didMove;
             }
-
-            if (didMove) {
-                s_HeadBobTimer       += (float)ts * m_bobSpeed;
-                s_BobAmplitudeBlend   = glm::mix(s_BobAmplitudeBlend, 1.0f, (float)ts * 10.0f);
-            } else {
-                s_BobAmplitudeBlend   = glm::mix(s_BobAmplitudeBlend, 0.0f, (float)ts * 10.0f);
-            }
         }
-        else
+        else if (m_IsPlayerMoving)
         {
-            if (m_IsPlayerMoving) {
-                rigSystem->Pause(m_RunAnimation);
-                m_IsPlayerMoving = false;
-            }
-            s_BobAmplitudeBlend = glm::mix(s_BobAmplitudeBlend, 0.0f, (float)ts * 10.0f);
-            if (s_BobAmplitudeBlend < 0.01f) {
-                s_BobAmplitudeBlend = 0.0f;
-                s_HeadBobTimer      = 0.0f;
-            }
+            rigSystem->Pause(m_RunAnimation);
+            m_IsPlayerMoving = false;
         }
 
-        float targetAmplitude = m_FirstPerson ? m_bobStrength : m_bobStrength / 2.0f;
-        float bobOffsetY      = glm::abs(glm::sin(s_HeadBobTimer)) * targetAmplitude * s_BobAmplitudeBlend;
-
-        glm::vec3 playerTopPos = pTransform.Translation + glm::vec3(0.0f, 1.0f + bobOffsetY, 0.0f);
-        glm::vec3 playerEyePos = pTransform.Translation + glm::vec3(0.0f, 1.7f + bobOffsetY, 0.0f);
-
         if (m_FirstPerson)
-        {
-            pTransform.Scale = { 0.001f, 0.001f, 0.001f };
-            m_Camera.SetDistance(0.0f);
-            m_Camera.SetFocalPoint(playerEyePos);
-            pTransform.Rotation = glm::quat(glm::vec3(0.0f, -m_Camera.GetYaw(), 0.0f));
-            pTransform.Dirty    = true;
-        }
-        else
-        {
-            pTransform.Scale = { 1.0f, 1.0f, 1.0f };
-            glm::vec3 shoulderOffset  = m_Camera.GetRightDirection() * 0.5f;
-            glm::vec3 stablePlayerPos = pTransform.Translation + glm::vec3(0.0f, 1.5f, 0.0f);
-            m_Camera.SetFocalPoint(stablePlayerPos + shoulderOffset);
-
-            if (m_LockCamera) {
-                m_Camera.SetDistance(5.0f);
-                if (m_Camera.GetPitch() < 0.2f) m_Camera.SetPitch(0.2f);
-            }
-        }
+            pTransform.Rotation = glm::quat(glm::vec3(0.0f, -input.cameraYaw, 0.0f));
 
         if (m_ShootTimer > 0.0f) {
-            m_ShootTimer -= (float)ts;
+            m_ShootTimer -= dt;
             if (m_ShootTimer < 0.0f) m_ShootTimer = 0.0f;
         }
 
         // --- RELOAD LOGIC ---
-        if (Aether::Input::IsKeyPressed(Aether::Key::R) && !m_IsReloading && m_CurrentAmmo < m_MaxAmmo)
+        if (input.reload && !m_IsReloading && m_CurrentAmmo < m_MaxAmmo)
         {
             m_IsReloading = true;
             m_ReloadTimer = m_ReloadDuration;
-            Aether::UUID src;
-            Aether::AudioSystem::CreateSource(src, m_GunReloadID, Aether::AudioType::Audio2D);
-            Aether::AudioSystem::Play(src);
-            sources.push_back(src);
+            m_Voices.PlayOneShot(m_GunReloadID);
             AE_INFO("Reloading...");
         }
 
         if (m_IsReloading) {
-            m_ReloadTimer    -= (float)ts;
-            m_ReloadRotation += (float)ts * 7.0f;
+            m_ReloadTimer    -= dt;
+            m_ReloadRotation += dt * 7.0f;
             if (m_ReloadTimer <= 0.0f) {
                 m_CurrentAmmo = m_MaxAmmo;
                 m_IsReloading = false;
@@ -374,58 +755,39 @@ void MainGameLayer::Update(Aether::Timestep ts)
         }
 
         if (m_AmmoEmptyTimer > 0.0f)
-            m_AmmoEmptyTimer -= (float)ts;
-
-        if (m_Scene.IsValid(m_SunLight)) {
-            auto& lightTransform       = m_Scene.GetComponent<Aether::TransformComponent>(m_SunLight);
-            lightTransform.Translation = playerTopPos + glm::vec3(0.0f, 50.0f, 0.0f);
-            lightTransform.Dirty       = true;
-            m_Scene.GetComponent<Aether::LightComponent>(m_SunLight).Config.castShadows = true;
-        }
+            m_AmmoEmptyTimer -= dt;
 
         UpdateMapChunks(pTransform.Translation);
 
-        m_FlowFieldTimer += (float)ts;
+        m_FlowFieldTimer += dt;
         if (m_FlowFieldTimer >= 0.2f) {
             UpdateFlowField(pTransform.Translation);
             m_FlowFieldTimer = 0.0f;
         }
 
         // --- ZOMBIE MANAGEMENT ---
-        static float s_TimeAccumulator = 0.0f;
-        s_TimeAccumulator += (float)ts;
-
         const float actualChunkSize = m_ChunkSize;
         const float despawnRadius   = (m_CurrentRenderDistance * actualChunkSize) + (actualChunkSize * 1.5f);
         const float despawnRadiusSq = despawnRadius * despawnRadius;
 
-        for (auto it = m_ActiveZombies.begin(); it != m_ActiveZombies.end(); )
+        for (uint32_t i = 0; i < m_Zombies.Size(); )
         {
-            Aether::Entity zombie = *it;
-            if (!m_Scene.IsValid(zombie)) { it = m_ActiveZombies.erase(it); continue; }
+            Aether::Entity zombie = m_Zombies.EntityAt(i);
+            if (!m_Scene.IsValid(zombie)) { DespawnZombie(i); continue; }
 
             auto&     zT   = m_Scene.GetComponent<Aether::TransformComponent>(zombie);
             glm::vec3 diff = pTransform.Translation - zT.Translation;
             diff.y = 0.0f;
 
-            if (glm::dot(diff, diff) > despawnRadiusSq)
-            {
-                auto& rec = m_ZombieRegistry[zombie];
-                rigSystem->DestroyAnimator(rec.animatorID);
-                Aether::PhysicsSystem::DestroyBody(rec.bodyID);
-                m_ZombieRegistry.erase(zombie);
-                m_Scene.DestroyHierarchy(zombie);
-                it = m_ActiveZombies.erase(it);
-            }
-            else { ++it; }
+            if (glm::dot(diff, diff) > despawnRadiusSq) DespawnZombie(i);
+            else                                        ++i;
         }
 
-        static float s_SpawnTimer = 0.0f;
-        s_SpawnTimer += (float)ts;
-        if (s_SpawnTimer >= 1.0f) {
-            s_SpawnTimer = 0.0f;
-            if (m_ActiveZombies.size() < maxZombies) {
-                float     randomAngle = glm::radians((float)(std::rand() % 360));
+        m_SpawnTimer += dt;
+        if (m_SpawnTimer >= 1.0f) {
+            m_SpawnTimer = 0.0f;
+            if (m_Zombies.Size() < (uint32_t)maxZombies) {
+                float     randomAngle = glm::radians((float)(m_SimRng() % 360));
                 float     spawnDist   = (m_CurrentRenderDistance * actualChunkSize);
                 glm::vec3 spawnPos    = pTransform.Translation
                     + glm::vec3(glm::cos(randomAngle), 0.0f, glm::sin(randomAngle)) * spawnDist;
@@ -434,27 +796,24 @@ void MainGameLayer::Update(Aether::Timestep ts)
             }
         }
 
-        static uint32_t s_ZombieUpdateCounter = 0;
-        s_ZombieUpdateCounter++;
-        int zombieIndex = 0;
-
-        for (Aether::Entity zombie : m_ActiveZombies)
+        PROFILE_ZONE("Zombie Steering");
+        for (uint32_t slot = 0; slot < m_Zombies.Size(); slot++)
         {
+            Aether::Entity zombie = m_Zombies.EntityAt(slot);
             if (!m_Scene.IsValid(zombie)) continue;
-            zombieIndex++;
-            if (zombieIndex % 2 != s_ZombieUpdateCounter % 2) continue;
 
             auto&    zT    = m_Scene.GetComponent<Aether::TransformComponent>(zombie);
             uint32_t zSeed = (uint32_t)zombie;
+            const glm::vec3 prevPos = zT.Translation;
+            const glm::quat prevRot = zT.Rotation;
 
-            int  zX     = static_cast<int>(std::floor(zT.Translation.x / m_PathGridSize));
-            int  zZ     = static_cast<int>(std::floor(zT.Translation.z / m_PathGridSize));
-            auto zCoord = std::make_pair(zX, zZ);
+            int zX = static_cast<int>(std::floor(zT.Translation.x / m_PathGridSize));
+            int zZ = static_cast<int>(std::floor(zT.Translation.z / m_PathGridSize));
 
             glm::vec3 baseDir(0.0f, 0.0f, 1.0f);
-            auto flowIt = m_FlowField.find(zCoord);
-            if (flowIt != m_FlowField.end() && glm::length(flowIt->second.direction) > 0.0000001f)
-                baseDir = flowIt->second.direction;
+            const FlowCell* flowCell = m_FlowField.Find(zX, zZ);
+            if (flowCell && glm::length(flowCell->direction) > 0.0000001f)
+                baseDir = flowCell->direction;
             else {
                 glm::vec3 diffBase = pTransform.Translation - zT.Translation;
                 diffBase.y = 0.0f;
@@ -462,24 +821,27 @@ void MainGameLayer::Update(Aether::Timestep ts)
             }
 
             glm::vec3 rightDir = glm::vec3(-baseDir.z, 0.0f, baseDir.x);
-            float     wobble   = glm::sin(s_TimeAccumulator * 2.5f + zSeed) * 0.35f;
+            float     wobble   = glm::sin((float)m_SimTime * 2.5f + zSeed) * 0.35f;
 
             glm::vec3 separationForce(0.0f);
-            const float sepRadiusSq = 0.64f;
-            int neighborCount = 0;
-            for (Aether::Entity other : m_ActiveZombies) {
-                if (other == zombie || !m_Scene.IsValid(other)) continue;
-                auto&     otherT = m_Scene.GetComponent<Aether::TransformComponent>(other);
-                glm::vec3 d      = zT.Translation - otherT.Translation;
-                d.y = 0.0f;
-                float distSq = glm::dot(d, d);
-                if (distSq > 0.001f && distSq < sepRadiusSq) {
-                    float dist = glm::sqrt(distSq);
-                    separationForce += (d / dist) * (0.8f - dist);
-                    neighborCount++;
+            {
+                PROFILE_ZONE("Zombie Separation");
+                const float sepRadiusSq = 0.64f;
+                int neighborCount = 0;
+                for (Aether::Entity other : m_Zombies.Entities()) {
+                    if (other == zombie || !m_Scene.IsValid(other)) continue;
+                    auto&     otherT = m_Scene.GetComponent<Aether::TransformComponent>(other);
+                    glm::vec3 d      = zT.Translation - otherT.Translation;
+                    d.y = 0.0f;
+                    float distSq = glm::dot(d, d);
+                    if (distSq > 0.001f && distSq < sepRadiusSq) {
+                        float dist = glm::sqrt(distSq);
+                        separationForce += (d / dist) * (0.8f - dist);
+                        neighborCount++;
+                    }
                 }
+                if (neighborCount > 0) separationForce /= (float)neighborCount;
             }
-            if (neighborCount > 0) separationForce /= (float)neighborCount;
 
             glm::vec3 totalForce   = baseDir + rightDir * wobble + separationForce * 0.5f;
             glm::vec3 finalMoveDir = (glm::length(totalForce) > 0.001f) ? glm::normalize(totalForce) : baseDir;
@@ -496,88 +858,48 @@ void MainGameLayer::Update(Aether::Timestep ts)
                 glm::quat targetRot   = glm::quat(glm::vec3(0.0f, targetAngle, 0.0f));
                 if (glm::dot(zT.Rotation, targetRot) < 0.0f) targetRot = -targetRot;
                 zT.Rotation = glm::normalize(
-                    glm::slerp(zT.Rotation, targetRot, 1.0f - glm::exp(-5.0f * (float)ts)));
+                    glm::slerp(zT.Rotation, targetRot, 1.0f - glm::exp(-5.0f * dt)));
 
                 glm::vec3 facing = zT.Rotation * glm::vec3(0.0f, 0.0f, 1.0f);
                 facing.y = 0.0f;
                 if (glm::length(facing) > 0.001f) {
                     float     zSpeedMult  = GetSpeedMultiplier(zT.Translation);
                     glm::vec3 newZombiePos = zT.Translation
-                        + glm::normalize(facing) * (actualSpeed * zSpeedMult * (float)ts);
+                        + glm::normalize(facing) * (actualSpeed * zSpeedMult * dt);
                     newZombiePos.y = yFloor;
                     Aether::PhysTransform zombieTarget{ newZombiePos, zT.Rotation };
-                    auto& zRec = m_ZombieRegistry[zombie];
+                    auto& zRec = m_Zombies.At(slot);
                     if (!IsObstacleWithRadius(newZombiePos) &&
                         Aether::PhysicsSystem::CanMove(zRec.bodyID, zombieTarget)) {
                         zT.Translation = newZombiePos;
-                        if (rigSystem) rigSystem->Play(zRec.animatorID);
+                        // Animation LOD: far away the run cycle is a few pixels tall, so skip evaluating it.
+                        const bool animate = glm::dot(diffToPlayer, diffToPlayer) < m_AnimLodDistance * m_AnimLodDistance;
+                        if (rigSystem && zRec.animPlaying != animate) {
+                            if (animate) rigSystem->Play(zRec.animatorID);
+                            else         rigSystem->Pause(zRec.animatorID);
+                            zRec.animPlaying = animate;
+                        }
                     } else {
                         zT.Translation.y = yFloor;
-                        if (rigSystem) rigSystem->Pause(zRec.animatorID);
+                        if (rigSystem && zRec.animPlaying) {
+                            rigSystem->Pause(zRec.animatorID);
+                            zRec.animPlaying = false;
+                        }
                     }
                 }
-                zT.Dirty = true;
+                if (zT.Translation != prevPos || zT.Rotation != prevRot) zT.Dirty = true;
             }
         }
     }
 
-    // --- SHADER UNIFORMS ---
-    m_MainShader->Bind();
-    m_MainShader->SetFloat ("u_Bias",       m_ShadowBias);
-    m_MainShader->SetInt   ("u_FogMode",    m_FogMode);
-    m_MainShader->SetFloat3("u_FogColor",   m_FogColor);
-    m_MainShader->SetFloat ("u_FogDensity", m_FogDensity);
-    m_MainShader->SetFloat ("u_FogStart",   m_FogStart);
-    m_MainShader->SetFloat ("u_FogEnd",     m_FogEnd);
-
-    // --- GUN POSITIONING ---
-    if (m_Scene.IsValid(m_Gun) && m_Scene.IsValid(m_Player))
-    {
-        auto& pTransform = m_Scene.GetComponent<Aether::TransformComponent>(m_Player);
-        auto& gTransform = m_Scene.GetComponent<Aether::TransformComponent>(m_Gun);
-
-        if (m_FirstPerson)
-        {
-            glm::vec3 camPos  = m_Camera.GetPosition();
-            glm::vec3 forward = m_Camera.GetForwardDirection();
-            glm::vec3 right   = m_Camera.GetRightDirection();
-            glm::vec3 up      = m_Camera.GetUpDirection();
-
-            gTransform.Translation = camPos + (right * m_GunPosFP.x) + (up * m_GunPosFP.y) + (forward * m_GunPosFP.z);
-            glm::quat camQuat      = glm::quat(glm::vec3(-m_Camera.GetPitch(), -m_Camera.GetYaw(), 0.0f));
-            gTransform.Rotation    = camQuat * glm::quat(glm::radians(m_GunRotFP));
-            gTransform.Scale       = m_GunScaleFP;
-        }
-        else
-        {
-            glm::quat pRot    = pTransform.Rotation;
-            glm::vec3 forward = pRot * glm::vec3(0.0f, 0.0f, -1.0f);
-            glm::vec3 right   = pRot * glm::vec3(1.0f, 0.0f,  0.0f);
-            glm::vec3 up      = pRot * glm::vec3(0.0f, 1.0f,  0.0f);
-
-            gTransform.Translation = pTransform.Translation
-                + (right * m_GunPosTP.x) + (up * m_GunPosTP.y) + (forward * m_GunPosTP.z);
-            gTransform.Rotation    = pRot * glm::quat(glm::radians(m_GunRotTP));
-            gTransform.Scale       = m_GunScaleTP;
-        }
-        gTransform.Dirty = true;
-    }
-
-    for (size_t i = 0; i < sources.size(); )
-    {
-        if (!Aether::AudioSystem::IsActive(sources[i]))
-        { sources[i] = sources.back(); sources.pop_back(); }
-        else i++;
-    }
-
     // --- PLAYER HEALTH ---
     if (m_DamageCooldown > 0.0f)
-        m_DamageCooldown -= ts;
+        m_DamageCooldown -= dt;
 
     if (m_Scene.IsValid(m_Player) && m_PlayerHealth > 0.0f && m_DamageCooldown <= 0.0f)
     {
         auto& pPos = m_Scene.GetComponent<Aether::TransformComponent>(m_Player).Translation;
-        for (auto zombie : m_ActiveZombies)
+        for (auto zombie : m_Zombies.Entities())
         {
             if (!m_Scene.IsValid(zombie)) continue;
             auto& zPos = m_Scene.GetComponent<Aether::TransformComponent>(zombie).Translation;
@@ -585,115 +907,308 @@ void MainGameLayer::Update(Aether::Timestep ts)
             {
                 m_PlayerHealth   -= 10.0f;
                 m_DamageCooldown  = 1.0f;
-                Aether::UUID src;
-                Aether::AudioSystem::CreateSource(src, m_ZombieBiteID, Aether::AudioType::Audio2D);
-                Aether::AudioSystem::Play(src);
-                sources.push_back(src);
+                m_Voices.PlayOneShot(m_ZombieBiteID);
                 AE_WARN("Player bit! HP remaining: {0}", m_PlayerHealth);
                 break;
             }
         }
     }
 
-    if (m_PlayerHealth <= 0.0f)
+    if (m_PlayerHealth <= 0.0f && input.respawn)
     {
-        // Hiển thị thông báo hoặc chờ bấm nút
-        if (Aether::Input::IsKeyPressed(Aether::Key::Space) || 
-            Aether::Input::IsMouseButtonPressed(Aether::Mouse::ButtonLeft))
-        {
-            m_ZombiesKilled = 0;
-            // 1. Reset chỉ số
-            m_PlayerHealth = 100.0f;
-            
-            // 2. Reset vị trí về tọa độ gốc (hoặc điểm spawn)
-            auto& pTrans = m_Scene.GetComponent<Aether::TransformComponent>(m_Player);
-            pTrans.Translation = glm::vec3(0.0f, yFloor, 0.0f);
-            
-            // 3. Reset Camera (nếu cần)
-            m_Camera.SetDistance(6.0f);
-            
-            AE_INFO("Player Resurrected!");
+        m_ZombiesKilled = 0;
+        // 1. Reset chỉ số
+        m_PlayerHealth = 100.0f;
+
+        // 2. Reset vị trí về tọa độ gốc (hoặc điểm spawn)
+        auto& pTrans = m_Scene.GetComponent<Aether::TransformComponent>(m_Player);
+        pTrans.Translation = glm::vec3(0.0f, yFloor, 0.0f);
+        pTrans.Dirty       = true;
+        m_PlayerPrevPose.position = pTrans.Translation; // teleport, don't interpolate across it
+
+        // 3. Reset Camera (nếu cần)
+        m_Camera.SetDistance(6.0f);
+
+        AE_INFO("Player Resurrected!");
+    }
+
+    // Capture the new authoritative poses.
+    if (m_Scene.IsValid(m_Player)) {
+        auto& t = m_Scene.GetComponent<Aether::TransformComponent>(m_Player);
+        m_PlayerPose = { t.Translation, t.Rotation };
+    }
+    for (uint32_t i = 0; i < m_Zombies.Size(); i++) {
+        Aether::Entity zombie = m_Zombies.EntityAt(i);
+        if (!m_Scene.IsValid(zombie)) continue;
+        auto& t = m_Scene.GetComponent<Aether::TransformComponent>(zombie);
+        m_Zombies.At(i).pose = { t.Translation, t.Rotation };
+    }
+}
+
+// =============================================================================
+//  Crowd audio
+// =============================================================================
+
+// Displayed zombie positions, in m_Zombies' dense order. Gathered on first use each frame.
+const std::vector<glm::vec3>& MainGameLayer::GatherZombiePositions()
+{
+    if (m_ZombieEmittersValid) return m_ZombieEmitters;
+
+    m_ZombieEmitters.clear();
+    for (auto zombie : m_Zombies.Entities())
+        if (m_Scene.IsValid(zombie))
+            m_ZombieEmitters.push_back(m_Scene.GetComponent<Aether::TransformComponent>(zombie).Translation);
+    m_ZombieEmittersValid = true;
+    return m_ZombieEmitters;
+}
+
+float MainGameLayer::BenchmarkCrowdAudio(uint32_t emitterCount)
+{
+    // Times the per-frame cull and top-N pick for a synthetic crowd spread out to twice the
+    // audible range. A separate, uninitialised CrowdAudio leaves the live voices alone.
+    std::mt19937                          rng(std::random_device{}());
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    CrowdAudio                            bench;
+
+    const glm::vec3 listener = m_Camera.GetPosition();
+    const float     range    = bench.GetSettings().MaxDistance * 2.0f;
+    std::vector<glm::vec3> emitters(emitterCount);
+    for (auto& emitter : emitters) {
+        float angle = glm::radians(unit(rng) * 360.0f);
+        float dist  = range * glm::sqrt(unit(rng));
+        emitter     = listener + glm::vec3(glm::cos(angle) * dist, 0.0f, glm::sin(angle) * dist);
+    }
+
+    const int iterations = 100;
+    uint32_t  voiced     = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        voiced = bench.Select(listener, emitters);
+    float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    AE_INFO("Crowd audio benchmark: {0} emitters, {1} audible -> {2} voices + ambience in {3:.4f} ms/frame",
+            emitterCount, bench.GetAudibleCount(), voiced, ms);
+    return ms;
+}
+
+// =============================================================================
+//  Shot queue
+// =============================================================================
+
+// Spreads pellets in a disc around the aim direction, drawing from the given generator.
+static void BuildPelletRays(const glm::vec3& origin, const glm::vec3& direction, int pellets, float spread,
+                            std::mt19937& rng, std::vector<ShotRay>& outRays)
+{
+    glm::vec3 right = glm::cross(direction, glm::vec3(0.0f, 1.0f, 0.0f));
+    right = (glm::length(right) > 0.001f) ? glm::normalize(right) : glm::vec3(1.0f, 0.0f, 0.0f);
+    glm::vec3 up    = glm::cross(right, direction);
+
+    for (int i = 0; i < pellets; i++)
+    {
+        glm::vec3 dir = direction;
+        if (pellets > 1) {
+            float angle  = glm::radians((float)(rng() % 360));
+            float radius = spread * ((rng() % 1000) / 1000.0f);
+            dir = glm::normalize(direction + (right * glm::cos(angle) + up * glm::sin(angle)) * radius);
         }
+        outRays.push_back({ origin, dir, 100.0f });
+    }
+}
+
+void MainGameLayer::QueueShot(const glm::vec3& origin, const glm::vec3& direction, int pellets, float spread)
+{
+    BuildPelletRays(origin, direction, pellets, spread, m_SimRng, m_ShotQueue);
+}
+
+// The BVH only holds zombies, so each ray is first cut short at whatever else would stop
+// it: a solid obstacle-map cell or the player's own capsule.
+void MainGameLayer::ClipShotRays(std::vector<ShotRay>& rays) const
+{
+    PROFILE_ZONE("ClipShotRays");
+    const bool                hasPlayer = m_Scene.IsValid(m_Player);
+    const HitscanBVH::Capsule player    { m_PlayerPose.position, k_CapsuleRadius, 2.5f };
+    auto isWall = [this](int x, int z) { return GetCellValue(x, z) >= 1.0f; };
+
+    for (ShotRay& ray : rays)
+    {
+        ray.MaxDistance = ClipRayToGrid(ray, m_PathGridSize, isWall);
+        if (!hasPlayer) continue;
+        float t = HitscanBVH::IntersectCapsule(ray, player);   // negative when the camera is inside it
+        if (t >= 0.0f && t < ray.MaxDistance) ray.MaxDistance = t;
     }
+}
 
-    m_Scene.Update(ts, &m_Camera);
+void MainGameLayer::BuildZombieBVH()
+{
+    // Capsule indices match m_Zombies' dense slots, so a hit maps straight back to its record.
+    // Built from the sim poses: the transforms may hold an interpolated pose at this point.
+    m_ZombieCapsules.clear();
+    for (uint32_t i = 0; i < m_Zombies.Size(); i++)
+    {
+        if (m_Scene.IsValid(m_Zombies.EntityAt(i)))
+            m_ZombieCapsules.push_back({ m_Zombies.At(i).pose.position, 0.35f, 2.0f });
+        else
+            m_ZombieCapsules.push_back({ glm::vec3(0.0f), 0.0f, 0.0f }); // empty slot, keeps indices aligned
+    }
+    m_ZombieBVH.Build(m_ZombieCapsules);
+}
+
+void MainGameLayer::ResolveShots()
+{
+    if (m_ShotQueue.empty()) return;
+    PROFILE_ZONE("ResolveShots");
+
+    auto start = std::chrono::steady_clock::now();
+
+    ClipShotRays(m_ShotQueue);
+    BuildZombieBVH();
+    m_ZombieBVH.CastBatch(m_ShotQueue, m_ShotHits);
+
+    m_LastShotRays      = (uint32_t)m_ShotQueue.size();
+    m_LastShotResolveMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    m_ShotQueue.clear();
+
+    // Several pellets can hit the same zombie; kill each once, highest slot first
+    // so swap-removing one never moves another pending slot.
+    m_KilledIndices.clear();
+    for (auto& hit : m_ShotHits) m_KilledIndices.push_back(hit.Target);
+    std::sort(m_KilledIndices.begin(), m_KilledIndices.end(), std::greater<uint32_t>());
+    m_KilledIndices.erase(std::unique(m_KilledIndices.begin(), m_KilledIndices.end()), m_KilledIndices.end());
+
+    for (uint32_t index : m_KilledIndices)
+    {
+        m_ZombiesKilled++;
+        if (m_ZombiesKilled > m_HighScore)
+            m_HighScore = m_ZombiesKilled;
+        DespawnZombie(index);
+    }
+}
+
+float MainGameLayer::BenchmarkPellets(int pellets)
+{
+    // Casts one shotgun-style volley without applying any hits. Its own generator and
+    // ray/hit lists keep the simulation RNG and any shots queued this tick untouched.
+    std::mt19937         rng(std::random_device{}());
+    std::vector<ShotRay> rays;
+    std::vector<ShotHit> hits;
+    BuildPelletRays(m_Camera.GetPosition(), glm::normalize(m_Camera.GetForwardDirection()),
+                    pellets, m_PelletSpread, rng, rays);
+
+    auto start = std::chrono::steady_clock::now();
+    ClipShotRays(rays);
+    BuildZombieBVH();
+    m_ZombieBVH.CastBatch(rays, hits);
+    float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    AE_INFO("Hitscan benchmark: {0} rays vs {1} zombies, {2} hits in {3:.4f} ms",
+            rays.size(), m_ZombieCapsules.size(), hits.size(), ms);
+    return ms;
+}
+
+void MainGameLayer::ApplyMainShaderUniforms()
+{
+    m_UniformSetsSkipped = 0;
+    bool bound = false;
+
+    auto apply = [&](auto& cached, const auto& value, auto&& set) {
+        if (m_UniformsApplied && cached == value) { m_UniformSetsSkipped++; return; }
+        if (!bound) { m_MainShader->Bind(); bound = true; }
+        set(value);
+        cached = value;
+    };
+
+    auto& c = m_AppliedUniforms;
+    apply(c.bias,       m_ShadowBias, [&](float v)            { m_MainShader->SetFloat ("u_Bias",       v); });
+    apply(c.fogMode,    m_FogMode,    [&](int v)              { m_MainShader->SetInt   ("u_FogMode",    v); });
+    apply(c.fogColor,   m_FogColor,   [&](const glm::vec3& v) { m_MainShader->SetFloat3("u_FogColor",   v); });
+    apply(c.fogDensity, m_FogDensity, [&](float v)            { m_MainShader->SetFloat ("u_FogDensity", v); });
+    apply(c.fogStart,   m_FogStart,   [&](float v)            { m_MainShader->SetFloat ("u_FogStart",   v); });
+    apply(c.fogEnd,     m_FogEnd,     [&](float v)            { m_MainShader->SetFloat ("u_FogEnd",     v); });
+
+    m_UniformsApplied = true;
 }
 
 void MainGameLayer::UpdateMapChunks(const glm::vec3& playerPos)
 {
+    PROFILE_ZONE("UpdateMapChunks");
+    ALLOC_SCOPE(AllocTag::Chunks);
     const float actualChunkSize = m_ChunkSize;
     int centerX = static_cast<int>(std::floor(playerPos.x / actualChunkSize));
     int centerZ = static_cast<int>(std::floor(playerPos.z / actualChunkSize));
 
-    std::set<std::pair<int, int>> chunksToKeep;
-
-    for (int x = -m_CurrentRenderDistance; x <= m_CurrentRenderDistance; ++x) {
-        for (int z = -m_CurrentRenderDistance; z <= m_CurrentRenderDistance; ++z) {
-            auto coord = std::make_pair(centerX + x, centerZ + z);
-            chunksToKeep.insert(coord);
-            if (m_ActiveChunks.count(coord)) continue;
-
-            Aether::Entity chunk = m_Scene.CreateEntity(
-                "MapGrid_" + std::to_string(coord.first) + "_" + std::to_string(coord.second));
-            auto& t = m_Scene.GetComponent<Aether::TransformComponent>(chunk);
-            t.Translation = glm::vec3(
-                (coord.first  + 0.5f) * actualChunkSize, -(actualChunkSize / 2.0f),
-                (coord.second + 0.5f) * actualChunkSize);
-
-            int   randomRot = std::rand() % 4;
-            float rotAngle  = glm::radians(randomRot * 90.0f);
-            t.Rotation = glm::quat(glm::vec3(0.0f, rotAngle, 0.0f));
-            t.Dirty    = true;
-
-            auto& mesh     = m_Scene.AddComponent<Aether::MeshComponent>(chunk);
-            mesh.Mesh      = m_BaseMapMesh;
-            mesh.Materials = m_BaseMapMaterials;
-
-            ChunkData newData;
-            newData.landEntity = chunk;
-            newData.rotation   = randomRot;
-            if (std::rand() % 100 < 80 && (std::abs(x) > 2 || std::abs(z) > 2)) {
-                glm::vec3 spawnPos = t.Translation;
-                spawnPos.y = yFloor;
-                Aether::Entity zEnt = SpawnZombie(spawnPos);
-                if (zEnt != Aether::Null_Entity) newData.zombies.push_back(zEnt);
-            }
-            m_ActiveChunks[coord] = newData;
+    FrameVector<ChunkCoord> chunksToKeep(m_FrameArena);
+    GatherChunksInRange(centerX, centerZ, m_CurrentRenderDistance, chunksToKeep);
+
+    for (const ChunkCoord& coord : chunksToKeep) {
+        if (m_ActiveChunks.count(coord)) continue;
+
+        const int x = coord.first - centerX, z = coord.second - centerZ;
+        ChunkData& newData = CreateChunk(coord, (int)(m_SimRng() % 4));
+        if (m_SimRng() % 100 < 80 && (std::abs(x) > 2 || std::abs(z) > 2)) {
+            glm::vec3 spawnPos = m_Scene.GetComponent<Aether::TransformComponent>(newData.landEntity).Translation;
+            spawnPos.y = yFloor;
+            Aether::Entity zEnt = SpawnZombie(spawnPos);
+            if (zEnt != Aether::Null_Entity) newData.zombies.push_back(zEnt);
         }
     }
 
-    for (auto it = m_ActiveChunks.begin(); it != m_ActiveChunks.end(); ) {
-        if (chunksToKeep.count(it->first)) { ++it; continue; }
+    FrameVector<ChunkCoord> chunksToUnload(m_FrameArena);
+    GatherChunksOutOfRange(m_ActiveChunks, chunksToKeep, chunksToUnload);
 
-        for (Aether::Entity zombie : it->second.zombies) {
-            if (!m_Scene.IsValid(zombie)) continue;
-            auto regIt = m_ZombieRegistry.find(zombie);
-            if (regIt != m_ZombieRegistry.end()) {
-                Aether::PhysicsSystem::DestroyBody(regIt->second.bodyID);
-                m_ZombieRegistry.erase(regIt);
-            }
-            m_ActiveZombies.erase(
-                std::remove(m_ActiveZombies.begin(), m_ActiveZombies.end(), zombie),
-                m_ActiveZombies.end());
-            m_Scene.DestroyHierarchy(zombie);
+    for (const ChunkCoord& coord : chunksToUnload) {
+        auto       it   = m_ActiveChunks.find(coord);
+        ChunkData& data = it->second;
+        for (Aether::Entity zombie : data.zombies) {
+            uint32_t slot = m_Zombies.IndexOf(zombie);
+            if (slot != EntitySparseSet<ZombieRecord>::k_Invalid) DespawnZombie(slot);
+            else if (m_Scene.IsValid(zombie))                    m_Scene.DestroyHierarchy(zombie);
         }
 
-        if (m_Scene.IsValid(it->second.landEntity))
-            m_Scene.DestroyEntity(it->second.landEntity);
-        it = m_ActiveChunks.erase(it);
+        if (m_Scene.IsValid(data.landEntity))
+            m_Scene.DestroyEntity(data.landEntity);
+        m_HierarchyDirty = true;
+        m_ActiveChunks.erase(it);
     }
 }
 
+MainGameLayer::ChunkData& MainGameLayer::CreateChunk(const std::pair<int, int>& coord, int rotation)
+{
+    ALLOC_SCOPE(AllocTag::Chunks);
+    m_HierarchyDirty = true;
+    char name[32];
+    std::snprintf(name, sizeof(name), "MapGrid_%d_%d", coord.first, coord.second);
+    Aether::Entity chunk = m_Scene.CreateEntity(name);
+    auto& t = m_Scene.GetComponent<Aether::TransformComponent>(chunk);
+    t.Translation = glm::vec3(
+        (coord.first  + 0.5f) * m_ChunkSize, -(m_ChunkSize / 2.0f),
+        (coord.second + 0.5f) * m_ChunkSize);
+    t.Rotation = glm::quat(glm::vec3(0.0f, glm::radians(rotation * 90.0f), 0.0f));
+    t.Dirty    = true;
+
+    auto& mesh     = m_Scene.AddComponent<Aether::MeshComponent>(chunk);
+    mesh.Mesh      = m_BaseMapMesh;
+    mesh.Materials = m_BaseMapMaterials;
+
+    ChunkData& data = m_ActiveChunks[coord];
+    data.landEntity = chunk;
+    data.rotation   = rotation;
+    data.zombies.clear();
+    return data;
+}
+
 Aether::Entity MainGameLayer::SpawnZombie(const glm::vec3& position)
 {
-    if (m_ActiveZombies.size() >= maxZombies) return Aether::Null_Entity;
+    if (m_Zombies.Size() >= (uint32_t)maxZombies) return Aether::Null_Entity;
+    ALLOC_SCOPE(AllocTag::Scene);
 
     static uint32_t s_ZombieCounter = 0;
     s_ZombieCounter++;
 
     auto rigSystem = Aether::AnimationSystem::GetModule<Aether::RigModule>();
 
-    Aether::UUID newAnimID = Aether::AssetsRegister::Register("ZombieAnim_" + std::to_string(s_ZombieCounter));
+    char animName[32];
+    std::snprintf(animName, sizeof(animName), "ZombieAnim_%u", s_ZombieCounter);
+    Aether::UUID newAnimID = Aether::AssetsRegister::Register(animName);
     if (rigSystem) {
         rigSystem->CloneAnimator(newAnimID, m_ZombieRunAnimation);
         rigSystem->BindClip(newAnimID, 4);
@@ -704,6 +1219,7 @@ Aether::Entity MainGameLayer::SpawnZombie(const glm::vec3& position)
     m_ZombieSceneData.animatorIDS[0] = newAnimID;
 
     Aether::Entity newZombie         = m_Scene.CreateEntity("Zombie_Minion");
+    m_HierarchyDirty                 = true;
     auto& zTransform                 = m_Scene.GetComponent<Aether::TransformComponent>(newZombie);
     zTransform.Translation           = position;
     zTransform.Scale                 = { 1.0f, 1.0f, 1.0f };
@@ -725,11 +1241,26 @@ Aether::Entity MainGameLayer::SpawnZombie(const glm::vec3& position)
         m_Scene.AddComponent<Aether::ColliderComponent>(newZombie, bodyID);
     }
 
-    m_ZombieRegistry[newZombie] = { newAnimID, bodyID };
-    m_ActiveZombies.push_back(newZombie);
+    SimPose pose { position, zTransform.Rotation };
+    m_Zombies.Insert(newZombie, { newAnimID, bodyID, rigSystem != nullptr, pose, pose });
     return newZombie;
 }
 
+void MainGameLayer::DespawnZombie(uint32_t slot)
+{
+    // Also used on records whose entity is already gone, so only the scene part is guarded.
+    Aether::Entity zombie    = m_Zombies.EntityAt(slot);
+    auto&          rec       = m_Zombies.At(slot);
+    auto           rigSystem = Aether::AnimationSystem::GetModule<Aether::RigModule>();
+
+    if (rigSystem) rigSystem->DestroyAnimator(rec.animatorID);
+    Aether::PhysicsSystem::DestroyBody(rec.bodyID);
+    if (m_Scene.IsValid(zombie)) m_Scene.DestroyHierarchy(zombie);
+
+    m_Zombies.RemoveAt(slot);
+    m_HierarchyDirty = true;
+}
+
 float MainGameLayer::GetCellValue(int coordX, int coordZ) const
 {
     int s = k_ObstacleMapSize;
@@ -801,77 +1332,138 @@ float MainGameLayer::GetSpeedMultiplier(const glm::vec3& worldPos) const
 
 void MainGameLayer::UpdateFlowField(const glm::vec3& targetPos)
 {
-    for (auto& [coord, cell] : m_FlowField) {
-        cell.bestCost  = 999999;
-        cell.direction = glm::vec3(0.0f);
-        cell.cost      = GetObstacleCost(coord.first, coord.second);
-    }
+    PROFILE_ZONE("UpdateFlowField");
+    ALLOC_SCOPE(AllocTag::FlowField);
+    int targetX = static_cast<int>(std::floor(targetPos.x / m_PathGridSize));
+    int targetZ = static_cast<int>(std::floor(targetPos.z / m_PathGridSize));
+    m_FlowField.Build(targetX, targetZ, m_FrameArena,
+                      [this](int x, int z) { return GetObstacleCost(x, z); });
+}
 
-    int  targetX     = static_cast<int>(std::floor(targetPos.x / m_PathGridSize));
-    int  targetZ     = static_cast<int>(std::floor(targetPos.z / m_PathGridSize));
-    auto targetCoord = std::make_pair(targetX, targetZ);
+// =============================================================================
+//  Save / snapshot
+// =============================================================================
 
-    m_FlowField[targetCoord].bestCost = 0;
-    m_FlowField[targetCoord].cost     = 1;
+Snapshot::Data MainGameLayer::CaptureSnapshot() const
+{
+    Snapshot::Data data;
+    data.MetaInfo.HighScore     = m_HighScore;
+    data.MetaInfo.ZombiesKilled = m_ZombiesKilled;
+
+    if (m_Scene.IsValid(m_Player)) {
+        const SimPose& t = m_PlayerPose;
+        auto& p = data.PlayerState;
+        p.Position[0] = t.position.x; p.Position[1] = t.position.y; p.Position[2] = t.position.z;
+        p.Rotation[0] = t.rotation.w; p.Rotation[1] = t.rotation.x;
+        p.Rotation[2] = t.rotation.y; p.Rotation[3] = t.rotation.z;
+        p.Health         = m_PlayerHealth;
+        p.DamageCooldown = m_DamageCooldown;
+        p.Ammo           = m_CurrentAmmo;
+        p.Reloading      = m_IsReloading ? 1u : 0u;
+        p.ReloadTimer    = m_ReloadTimer;
+        p.CameraYaw      = m_Camera.GetYaw();
+        p.CameraPitch    = m_Camera.GetPitch();
+        p.CameraDistance = m_Camera.GetDistance();
+        p.FirstPerson    = m_FirstPerson ? 1u : 0u;
+    }
 
-    static const std::vector<std::pair<int, int>> neighbors = {
-        {0, 1}, {0,-1}, {1, 0}, {-1, 0},
-        {1, 1}, {1,-1}, {-1, 1}, {-1,-1}
+    data.Chunks.reserve(m_ActiveChunks.size());
+    data.Zombies.reserve(m_Zombies.Size());
+    std::vector<uint8_t> owned(m_Zombies.Size(), 0);
+
+    auto pushZombie = [&](Aether::Entity zombie, const std::pair<int, int>* chunk) {
+        const ZombieRecord* rec = m_Zombies.TryGet(zombie);
+        if (!rec || !m_Scene.IsValid(zombie)) return;
+        const SimPose& t = rec->pose;
+        Snapshot::Zombie z {};
+        z.Position[0] = t.position.x; z.Position[1] = t.position.y; z.Position[2] = t.position.z;
+        z.Rotation[0] = t.rotation.w; z.Rotation[1] = t.rotation.x;
+        z.Rotation[2] = t.rotation.y; z.Rotation[3] = t.rotation.z;
+        if (chunk) { z.ChunkX = chunk->first; z.ChunkZ = chunk->second; z.OwnedByChunk = 1; }
+        data.Zombies.push_back(z);
     };
 
-    const int maxRadius = 40;
-    std::queue<std::pair<int, int>> openList;
-    openList.push(targetCoord);
-
-    while (!openList.empty())
-    {
-        auto current = openList.front(); openList.pop();
-        if (std::abs(current.first  - targetX) > maxRadius ||
-            std::abs(current.second - targetZ) > maxRadius) continue;
+    for (auto& [coord, chunk] : m_ActiveChunks) {
+        data.Chunks.push_back({ coord.first, coord.second, chunk.rotation, 0 });
+        for (Aether::Entity zombie : chunk.zombies) {
+            uint32_t slot = m_Zombies.IndexOf(zombie);
+            if (slot == EntitySparseSet<ZombieRecord>::k_Invalid) continue;
+            owned[slot] = 1;
+            pushZombie(zombie, &coord);
+        }
+    }
+    for (uint32_t i = 0; i < m_Zombies.Size(); i++)
+        if (!owned[i]) pushZombie(m_Zombies.EntityAt(i), nullptr);
 
-        int currCost = m_FlowField[current].bestCost;
+    return data;
+}
 
-        for (auto& [dx, dz] : neighbors)
-        {
-            auto neighborCoord = std::make_pair(current.first + dx, current.second + dz);
+void MainGameLayer::SaveSnapshotAsync()
+{
+    if (m_PendingSave.valid()) m_PendingSave.wait(); // one write in flight at a time
+
+    m_PendingSave = std::async(std::launch::async, [data = CaptureSnapshot()]() {
+        auto start = std::chrono::steady_clock::now();
+        PROFILE_ZONE("Snapshot::Write");
+        bool ok    = Snapshot::Write("save.dat", data);
+        float ms   = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (ok) AE_INFO("Saved {0} chunks, {1} zombies in {2:.2f} ms", data.Chunks.size(), data.Zombies.size(), ms);
+        else    AE_ERROR("Failed to write save.dat");
+        return ok;
+    });
+}
 
-            if (!m_FlowField.count(neighborCoord)) {
-                int obsCost = GetObstacleCost(neighborCoord.first, neighborCoord.second);
-                m_FlowField[neighborCoord] = { obsCost, 999999, glm::vec3(0.0f) };
-            }
+void MainGameLayer::ApplySnapshot(const Snapshot::File& file)
+{
+    uint64_t count = 0;
 
-            auto& neighbor = m_FlowField[neighborCoord];
-            if (neighbor.cost >= 255) continue;
+    if (auto* meta = file.Get<Snapshot::Meta>(Snapshot::k_TagMeta, count); meta && count == 1) {
+        m_HighScore     = meta->HighScore;
+        m_ZombiesKilled = meta->ZombiesKilled;
+    }
 
-            int moveCost = (dx != 0 && dz != 0) ? 14 : 10;
-            int newCost  = currCost + (moveCost * neighbor.cost);
+    if (auto* p = file.Get<Snapshot::Player>(Snapshot::k_TagPlayer, count); p && count == 1 && m_Scene.IsValid(m_Player)) {
+        auto& t = m_Scene.GetComponent<Aether::TransformComponent>(m_Player);
+        t.Translation = { p->Position[0], p->Position[1], p->Position[2] };
+        t.Rotation    = glm::quat(p->Rotation[0], p->Rotation[1], p->Rotation[2], p->Rotation[3]);
+        t.Dirty       = true;
+
+        m_PlayerHealth   = p->Health;
+        m_DamageCooldown = p->DamageCooldown;
+        m_CurrentAmmo    = p->Ammo;
+        m_IsReloading    = p->Reloading != 0;
+        m_ReloadTimer    = p->ReloadTimer;
+        m_FirstPerson    = p->FirstPerson != 0;
+        t.Scale          = m_FirstPerson ? glm::vec3(0.001f) : glm::vec3(1.0f);
+        m_Camera.SetYaw(p->CameraYaw);
+        m_Camera.SetPitch(p->CameraPitch);
+        m_Camera.SetDistance(p->CameraDistance);
+    }
 
-            if (newCost < neighbor.bestCost) {
-                neighbor.bestCost = newCost;
-                openList.push(neighborCoord);
-            }
+    if (auto* chunks = file.Get<Snapshot::Chunk>(Snapshot::k_TagChunks, count)) {
+        for (uint64_t i = 0; i < count; i++) {
+            auto coord = std::make_pair(chunks[i].X, chunks[i].Z);
+            if (!m_ActiveChunks.count(coord)) CreateChunk(coord, chunks[i].Rotation & 3);
         }
     }
 
-    for (auto& [coord, cell] : m_FlowField)
-    {
-        if (cell.cost >= 255 || cell.bestCost == 999999) continue;
+    if (auto* zombies = file.Get<Snapshot::Zombie>(Snapshot::k_TagZombies, count)) {
+        for (uint64_t i = 0; i < count; i++) {
+            const auto& z = zombies[i];
+            Aether::Entity entity = SpawnZombie({ z.Position[0], z.Position[1], z.Position[2] });
+            if (entity == Aether::Null_Entity) break; // crowd cap reached
 
-        glm::vec3 avgDir(0.0f);
-        for (auto& [dx, dz] : neighbors)
-        {
-            auto neighborCoord = std::make_pair(coord.first + dx, coord.second + dz);
-            auto it = m_FlowField.find(neighborCoord);
-            if (it == m_FlowField.end()) continue;
-
-            int neighborCost = it->second.bestCost;
-            if (neighborCost < cell.bestCost) {
-                float pullStrength = float(cell.bestCost - neighborCost);
-                avgDir += glm::normalize(glm::vec3((float)dx, 0.0f, (float)dz)) * pullStrength;
+            m_Scene.GetComponent<Aether::TransformComponent>(entity).Rotation =
+                glm::quat(z.Rotation[0], z.Rotation[1], z.Rotation[2], z.Rotation[3]);
+
+            if (z.OwnedByChunk) {
+                auto it = m_ActiveChunks.find({ z.ChunkX, z.ChunkZ });
+                if (it != m_ActiveChunks.end()) it->second.zombies.push_back(entity);
             }
         }
-        cell.direction = (glm::length(avgDir) > 0.01f) ? glm::normalize(avgDir) : glm::vec3(0.0f);
     }
+
+    m_FlowFieldTimer = 0.2f; // rebuild the flow field on the first tick
 }
 
 // =============================================================================
@@ -922,6 +1514,13 @@ void MainGameLayer::OnImGuiRender()
     // --- PERF OVERLAY (top-left) ---
     UI::PerformanceOverlay(0, 30, 60);
 
+    if (m_ShowAllocOverlay && AllocTracker::IsActive()) {
+        glm::vec2 pos = UI::Screen::Anchor(0.0f, 0.0f) + glm::vec2(10.0f, 120.0f);
+        if (auto w = UI::Overlay("AllocOverlay", {pos.x, pos.y}))
+            UI::TextColored(AllocTracker::GetFrameAllocs() ? UI::Color::Orange() : UI::Color::Green(),
+                            "%llu allocs / frame", (unsigned long long)AllocTracker::GetFrameAllocs());
+    }
+
     // --- CROSSHAIR ---
     // --- CROSSHAIR ---
     {
@@ -981,63 +1580,57 @@ void MainGameLayer::OnImGuiRender()
         }
     }
 
-    // --- FLOW FIELD DEBUG OVERLAY ---
-    if (m_ShowFlowFieldDebug && !m_FlowField.empty())
+    // --- FLOW FIELD / CHUNK DEBUG OVERLAY ---
+    if (m_ShowFlowFieldDebug)
     {
-        auto      cv       = UI::Foreground();
-        glm::mat4 viewProj = m_Camera.GetViewProjection();
+        m_DebugDraw.Begin(m_Camera.GetViewProjection(), UI::Screen::Pos(), UI::Screen::Size());
 
         const ImU32 colGrid   = UI::Col32(  0, 255,   0,  80);
         const ImU32 colDir    = UI::Col32(  0, 255,   0, 200);
         const ImU32 colTarget = UI::Col32(255, 255,   0, 255);
         const float half      = m_PathGridSize * 0.5f;
+        const float cellCull  = half * 1.5f; // bounding radius of a cell quad
+
+        const int side    = m_FlowField.GetSide();
+        int       maxCost = 1;
+        if (m_ShowFlowFieldHeatmap)
+            for (int i = 0; i < side * side; i++) {
+                const FlowCell& cell = m_FlowField.At(i % side, i / side);
+                if (cell.bestCost != FlowField::k_Unreached) maxCost = std::max(maxCost, cell.bestCost);
+            }
 
-        for (auto& [coord, cell] : m_FlowField)
+        for (int i = 0; i < side * side; i++)
         {
-            if (cell.bestCost == 999999) continue;
+            const FlowCell& cell = m_FlowField.At(i % side, i / side);
+            if (cell.bestCost == FlowField::k_Unreached) continue;
 
             glm::vec3 worldCenter = {
-                (coord.first  + 0.5f) * m_PathGridSize,
+                (m_FlowField.GetMinX() + i % side + 0.5f) * m_PathGridSize,
                 yFloor + 0.05f,
-                (coord.second + 0.5f) * m_PathGridSize
-            };
-
-            glm::vec3 corners[4] = {
-                worldCenter + glm::vec3(-half, 0, -half),
-                worldCenter + glm::vec3( half, 0, -half),
-                worldCenter + glm::vec3( half, 0,  half),
-                worldCenter + glm::vec3(-half, 0,  half),
+                (m_FlowField.GetMinZ() + i / side + 0.5f) * m_PathGridSize
             };
+            if (!m_DebugDraw.IsVisible(worldCenter, cellCull)) continue;
 
-            glm::vec2 sc[4]; bool allVisible = true;
-            for (int i = 0; i < 4; i++)
-                if (!UI::Screen::Project(corners[i], viewProj, sc[i])) { allVisible = false; break; }
-            if (!allVisible) continue;
+            glm::vec3 c0 = worldCenter + glm::vec3(-half, 0, -half);
+            glm::vec3 c1 = worldCenter + glm::vec3( half, 0, -half);
+            glm::vec3 c2 = worldCenter + glm::vec3( half, 0,  half);
+            glm::vec3 c3 = worldCenter + glm::vec3(-half, 0,  half);
 
-            cv.Quad(sc[0], sc[1], sc[2], sc[3],
-                    (cell.bestCost == 0) ? colTarget : colGrid, 1.f);
+            if (m_ShowFlowFieldHeatmap) {
+                float t = (float)cell.bestCost / (float)maxCost;
+                m_DebugDraw.QuadFilled(c0, c1, c2, c3,
+                    UI::Col32((int)(255 * t), (int)(255 * (1.0f - t)), 0, 90));
+            }
+            m_DebugDraw.Quad(c0, c1, c2, c3, (cell.bestCost == 0) ? colTarget : colGrid, 1.f);
 
             if (cell.bestCost > 0 && glm::length(cell.direction) > 0.01f)
-            {
-                glm::vec3 arrowEnd3 = worldCenter + cell.direction * (m_PathGridSize * 0.4f);
-                glm::vec2 sCenter, sEnd;
-                if (UI::Screen::Project(worldCenter, viewProj, sCenter) &&
-                    UI::Screen::Project(arrowEnd3,   viewProj, sEnd))
-                {
-                    cv.Arrow(sCenter, sEnd, colDir, 1.5f, 4.f);
-                }
-            }
+                m_DebugDraw.Arrow(worldCenter, worldCenter + cell.direction * (m_PathGridSize * 0.4f),
+                                  colDir, 1.5f, 4.f);
         }
-    }
-
-    if (m_ShowFlowFieldDebug && !m_ActiveChunks.empty())
-    {
-        auto      cv       = UI::Foreground();
-        glm::mat4 viewProj = m_Camera.GetViewProjection();
 
-        const float half     = m_ChunkSize * 0.5f;
-        const ImU32 colChunk = UI::Col32(255,  0,  0, 160);
-        const ImU32 colLabel = UI::Col32(255, 80, 80, 255);
+        const float chunkHalf = m_ChunkSize * 0.5f;
+        const ImU32 colChunk  = UI::Col32(255,  0,  0, 160);
+        const ImU32 colLabel  = UI::Col32(255, 80, 80, 255);
 
         for (auto& [coord, chunkData] : m_ActiveChunks)
         {
@@ -1046,28 +1639,20 @@ void MainGameLayer::OnImGuiRender()
                 yFloor + 0.05f,
                 (coord.second + 0.5f) * m_ChunkSize
             };
+            if (!m_DebugDraw.IsVisible(worldCenter, chunkHalf * 1.5f)) continue;
 
-            glm::vec3 corners[4] = {
-                worldCenter + glm::vec3(-half, 0.f, -half),
-                worldCenter + glm::vec3( half, 0.f, -half),
-                worldCenter + glm::vec3( half, 0.f,  half),
-                worldCenter + glm::vec3(-half, 0.f,  half),
-            };
-
-            glm::vec2 sc[4]; bool allVisible = true;
-            for (int i = 0; i < 4; i++)
-                if (!UI::Screen::Project(corners[i], viewProj, sc[i])) { allVisible = false; break; }
-            if (!allVisible) continue;
-
-            cv.Quad(sc[0], sc[1], sc[2], sc[3], colChunk, 2.f);
+            m_DebugDraw.Quad(worldCenter + glm::vec3(-chunkHalf, 0.f, -chunkHalf),
+                             worldCenter + glm::vec3( chunkHalf, 0.f, -chunkHalf),
+                             worldCenter + glm::vec3( chunkHalf, 0.f,  chunkHalf),
+                             worldCenter + glm::vec3(-chunkHalf, 0.f,  chunkHalf),
+                             colChunk, 2.f);
 
-            glm::vec2 sCenter;
-            if (UI::Screen::Project(worldCenter, viewProj, sCenter)) {
-                char buf[32];
-                snprintf(buf, sizeof(buf), "%d,%d", coord.first, coord.second);
-                cv.Text(sCenter, colLabel, buf);
-            }
+            char buf[32];
+            snprintf(buf, sizeof(buf), "%d,%d", coord.first, coord.second);
+            m_DebugDraw.Text(worldCenter, colLabel, buf);
         }
+
+        m_DebugDraw.Flush(ImGui::GetForegroundDrawList());
     }
 
     // --- HEALTH BAR ---
@@ -1103,10 +1688,11 @@ void MainGameLayer::OnImGuiRender()
             IM_COL32(200, 200, 200, 220), respawnText);
     }
 
-    DrawRadar();
+    if (m_ShowRadar) DrawRadar();
     DrawHierarchyPanel();
     DrawScenePanel();
     DrawLightingPanel();
+    if (m_ShowProfiler) Profiler::DrawPanel(&m_ShowProfiler);
     
     // --- SCOREBOARD ---
     ImGui::SetNextWindowPos(ImVec2(20, 20), ImGuiCond_FirstUseEver); 
@@ -1123,18 +1709,27 @@ void MainGameLayer::OnImGuiRender()
 
 void MainGameLayer::OnEvent(Aether::Event& event)
 {
+    // During a replay every gameplay input comes from the recording.
+    if (m_InputMode == InputMode::Replay) return;
+
     m_Camera.OnEvent(event);
-    auto& pTransform = m_Scene.GetComponent<Aether::TransformComponent>(m_Player);
 
     // V: toggle perspective
     if (event.GetEventType() == Aether::EventType::KeyPressed &&
         Aether::Input::IsKeyPressed(Aether::Key::V))
     {
-        m_FirstPerson    = !m_FirstPerson;
-        pTransform.Scale = m_FirstPerson ? glm::vec3(0.001f) : glm::vec3(1.0f);
-        m_Camera.SetDistance(m_FirstPerson ? 0.5f : 6.0f);
-        pTransform.Dirty = true;
-        event.Handled    = true;
+        RaiseAction(InputActionType::TogglePerspective);
+        event.Handled = true;
+        return;
+    }
+
+    // F5: quicksave, live sessions only so recording never touches save.dat
+    if (event.GetEventType() == Aether::EventType::KeyPressed &&
+        Aether::Input::IsKeyPressed(Aether::Key::F5))
+    {
+        if (m_SaveOnExit) SaveSnapshotAsync();
+        else              AE_WARN("Quicksave is disabled while recording input");
+        event.Handled = true;
         return;
     }
 
@@ -1144,18 +1739,15 @@ void MainGameLayer::OnEvent(Aether::Event& event)
         auto& e = (Aether::MouseScrolledEvent&)event;
         if (!m_FirstPerson) {
             if (e.GetYOffset() > 0 && m_Camera.GetDistance() < 1.3f) {
-                m_FirstPerson = true;
-                m_Camera.SetDistance(0.5f);
+                RaiseAction(InputActionType::EnterFirstPerson);
                 event.Handled = true;
                 return;
             }
             if (m_LockCamera) { event.Handled = true; return; }
         }
         else {
-            if (e.GetYOffset() < 0) {
-                m_FirstPerson = false;
-                m_Camera.SetDistance(6.0f);
-            }
+            if (e.GetYOffset() < 0)
+                RaiseAction(InputActionType::ExitFirstPerson);
             event.Handled = true;
             return;
         }
@@ -1163,12 +1755,58 @@ void MainGameLayer::OnEvent(Aether::Event& event)
 
     // LMB: shoot
     if (event.GetEventType() == Aether::EventType::MouseButtonPressed &&
-        Aether::Input::IsMouseButtonPressed(Aether::Mouse::Button0) &&
-        m_PlayerHealth > 0.0f)
+        Aether::Input::IsMouseButtonPressed(Aether::Mouse::Button0))
     {
-        if (m_IsReloading)    { AE_WARN("Can't shoot while reloading!"); return; }
-        if (m_CurrentAmmo <= 0) { m_AmmoEmptyTimer = 1.0f; AE_WARN("Out of ammo! Press R"); return; }
-        if (m_ShootTimer > 0.0f) return;
+        if (RaiseAction(InputActionType::Fire)) event.Handled = true;
+    }
+}
+
+bool MainGameLayer::RaiseAction(InputActionType type)
+{
+    InputAction action {};
+    action.Type = type;
+    if (type == InputActionType::Fire) {
+        // Aimed now: scroll zoom and the follow camera can still move it before the frame is recorded.
+        glm::vec3 origin    = m_Camera.GetPosition();
+        glm::vec3 direction = glm::normalize(m_Camera.GetForwardDirection());
+        action.Origin[0]    = origin.x;    action.Origin[1]    = origin.y;    action.Origin[2]    = origin.z;
+        action.Direction[0] = direction.x; action.Direction[1] = direction.y; action.Direction[2] = direction.z;
+    }
+
+    if (m_InputMode == InputMode::Record)
+        m_FrameActions.push_back(action);
+    return HandleAction(action);
+}
+
+bool MainGameLayer::HandleAction(const InputAction& action)
+{
+    switch (action.Type)
+    {
+    case InputActionType::TogglePerspective:
+    {
+        auto& pTransform = m_Scene.GetComponent<Aether::TransformComponent>(m_Player);
+        m_FirstPerson    = !m_FirstPerson;
+        pTransform.Scale = m_FirstPerson ? glm::vec3(0.001f) : glm::vec3(1.0f);
+        m_Camera.SetDistance(m_FirstPerson ? 0.5f : 6.0f);
+        pTransform.Dirty = true;
+        return true;
+    }
+    case InputActionType::EnterFirstPerson:
+        m_FirstPerson = true;
+        m_Camera.SetDistance(0.5f);
+        return true;
+
+    case InputActionType::ExitFirstPerson:
+        m_FirstPerson = false;
+        m_Camera.SetDistance(6.0f);
+        return true;
+
+    case InputActionType::Fire:
+    {
+        if (m_PlayerHealth <= 0.0f) return false;
+        if (m_IsReloading)    { AE_WARN("Can't shoot while reloading!"); return false; }
+        if (m_CurrentAmmo <= 0) { m_AmmoEmptyTimer = 1.0f; AE_WARN("Out of ammo! Press R"); return false; }
+        if (m_ShootTimer > 0.0f) return false;
 
         m_CurrentAmmo--;
         m_ShootTimer = m_ShootDuration;
@@ -1180,43 +1818,33 @@ void MainGameLayer::OnEvent(Aether::Event& event)
             rigSystem->Play(m_ShootAnimation);
         }
 
-        Aether::UUID src;
-        Aether::AudioSystem::CreateSource(src, m_GunSoundID, Aether::AudioType::Audio2D);
-        Aether::AudioSystem::SetVolume(src, 0.3f);
-        sources.push_back(src);
-        Aether::AudioSystem::Play(src);
-
-        glm::vec3          origin    = m_Camera.GetPosition();
-        glm::vec3          direction = glm::normalize(m_Camera.GetForwardDirection());
-        Aether::RaycastHit hit       = Aether::PhysicsSystem::CastRay(origin, direction, 100.0f);
-
-        // Tìm đoạn này trong MainGameLayer.cpp (khoảng cuối file)
-        if (hit.Hit) {
-            Aether::Entity target = m_Scene.FindEntity(hit.HitEntityID);
-            if (target != Aether::Null_Entity && target != m_Player) {
-                if (m_ZombieRegistry.count(target)) { // Kiểm tra thực thể có phải Zombie
-                    auto& rec = m_ZombieRegistry[target];
-                    
-                    // --- THÊM LOGIC CỦA BẠN TẠI ĐÂY ---
-                    m_ZombiesKilled++; // Tăng số lượng zombie đã giết
-                    if (m_ZombiesKilled > m_HighScore) {
-                        m_HighScore = m_ZombiesKilled; 
-                    }
-                    
-                    // Ví dụ thêm:
-                    // m_Score += 100; // Cộng điểm
-                    // Aether::AudioSystem::Play(m_ZombieDeathSoundID); // Phát âm thanh chết
-                    
-                    // Logic xóa zombie hiện có của bạn
-                    Aether::PhysicsSystem::DestroyBody(rec.bodyID);
-                    m_Scene.DestroyHierarchy(target);
-                    m_ActiveZombies.erase(std::remove(m_ActiveZombies.begin(), m_ActiveZombies.end(), target), m_ActiveZombies.end());
-                    m_ZombieRegistry.erase(target);
-                }
-            }
-        }
-        event.Handled = true;
+        m_Voices.PlayOneShot(m_GunSoundID, 0.3f);
+
+        QueueShot({ action.Origin[0],    action.Origin[1],    action.Origin[2] },
+                  { action.Direction[0], action.Direction[1], action.Direction[2] },
+                  m_PelletsPerShot, m_PelletSpread);
+        return true;
     }
+    }
+    return false;
+}
+
+void MainGameLayer::FinishReplay()
+{
+    AE_INFO("Replay finished after {0} frames", m_StageTimings.GetFrameCount());
+    for (uint32_t stage = 0; stage < m_StageTimings.GetStageCount(); stage++)
+        AE_INFO("  {0}: {1:.3f} ms/frame", m_StageTimings.GetStageName(stage), m_StageTimings.GetMeanMs(stage));
+
+    const std::string csvPath = m_InputPath + ".timings.csv";
+    if (m_StageTimings.WriteCsv(csvPath)) AE_INFO("Stage timings written to {0}", csvPath);
+    else                                  AE_ERROR("Failed to write {0}", csvPath);
+
+    const std::string tracePath = m_InputPath + ".trace.json";
+    if (Profiler::WriteChromeTrace(tracePath)) AE_INFO("Profiler trace written to {0}", tracePath);
+    Profiler::SetEnabled(false);
+
+    // Hand control back to the player; save.dat stays untouched for this session.
+    m_InputMode = InputMode::Live;
 }
 
 // =============================================================================
@@ -1254,27 +1882,50 @@ void MainGameLayer::DrawRadar()
         float     cosA       = cosf(-m_Camera.GetYaw());
         float     sinA       = sinf(-m_Camera.GetYaw());
 
-        for (auto zombie : m_ActiveZombies)
         {
-            if (!m_Scene.IsValid(zombie)) continue;
+            PROFILE_ZONE("Radar Grid");
+            ALLOC_SCOPE(AllocTag::Crowd);
+            m_ZombieGrid.Build(GatherZombiePositions());
+        }
 
-            glm::vec3 zPos = m_Scene.GetComponent<TransformComponent>(zombie).Translation;
-            float relX = zPos.x - pPos.x;
-            float relZ = zPos.z - pPos.z;
-            float dist = sqrtf(relX * relX + relZ * relZ);
+        // Only agents inside the tracking radius come back from the grid, already
+        // relative to the player and tested against the squared distance.
+        m_RadarRelX.clear();
+        m_RadarRelZ.clear();
+        m_ZombieGrid.QueryRadius(pPos, maxTrackDistance, [&](uint32_t, float dx, float dz) {
+            m_RadarRelX.push_back(dx);
+            m_RadarRelZ.push_back(dz);
+        });
+
+        // Rotate the whole batch into radar space and accumulate density bins.
+        const float scale   = radarRadius / maxTrackDistance;
+        const float binSize = (2.0f * radarRadius) / k_RadarBins;
+        m_RadarBins.assign(k_RadarBins * k_RadarBins, RadarBin{});
+        for (size_t i = 0; i < m_RadarRelX.size(); i++)
+        {
+            float ox = (m_RadarRelX[i] * cosA - m_RadarRelZ[i] * sinA) * scale;
+            float oy = (m_RadarRelX[i] * sinA + m_RadarRelZ[i] * cosA) * scale;
+            int   bx = std::clamp((int)((ox + radarRadius) / binSize), 0, k_RadarBins - 1);
+            int   by = std::clamp((int)((oy + radarRadius) / binSize), 0, k_RadarBins - 1);
+            auto& bin = m_RadarBins[by * k_RadarBins + bx];
+            bin.count++;
+            bin.sumX += ox;
+            bin.sumY += oy;
+        }
 
-            if (dist <= maxTrackDistance)
-            {
-                float rx = relX * cosA - relZ * sinA;
-                float ry = relX * sinA + relZ * cosA;
-                float ox = (rx / maxTrackDistance) * radarRadius;
-                float oy = (ry / maxTrackDistance) * radarRadius;
+        // One blip per occupied bin at its average position; crowds grow the blip instead of stacking circles.
+        for (const auto& bin : m_RadarBins)
+        {
+            if (bin.count == 0) continue;
+            float ox = bin.sumX / bin.count;
+            float oy = bin.sumY / bin.count;
 
-                float d = sqrtf(ox * ox + oy * oy);
-                if (d > radarRadius - 3.0f) { float s = (radarRadius - 3.0f) / d; ox *= s; oy *= s; }
+            float dSq = ox * ox + oy * oy;
+            float lim = radarRadius - 3.0f;
+            if (dSq > lim * lim) { float s = lim / sqrtf(dSq); ox *= s; oy *= s; }
 
-                cv.CircleFill(center + glm::vec2(ox, oy), 3.5f, UI::Col32(255, 50, 50, 255));
-            }
+            float blipRadius = 3.5f + 1.5f * log2f((float)bin.count);
+            cv.CircleFill(center + glm::vec2(ox, oy), blipRadius, UI::Col32(255, 50, 50, 255));
         }
 
         cv.CircleFill(center, 5.0f, UI::Col32(255, 255, 255, 255));
@@ -1293,14 +1944,43 @@ void MainGameLayer::DrawHierarchyPanel()
 {
     ImGui::Begin("Scene Hierarchy");
 
-    // Sử dụng View để lấy tất cả thực thể có TagComponent (tên)
-    auto view = m_Scene.View<Aether::TagComponent>();
-    
-    for (auto entity : view)
+    bool refilter = m_HierarchyFilter.Draw("Filter");
+    if (m_HierarchyDirty) {
+        RebuildHierarchyCache();
+        refilter = true;
+    }
+
+    // The filter only runs when the text or the entity set changes, not every frame.
+    if (refilter) {
+        m_HierarchyFiltered.clear();
+        for (uint32_t i = 0; i < (uint32_t)m_HierarchyEntities.size(); i++) {
+            Aether::Entity entity = m_HierarchyEntities[i];
+            if (!m_Scene.IsValid(entity)) continue;
+            if (m_HierarchyFilter.IsActive() &&
+                !m_HierarchyFilter.PassFilter(m_Scene.GetComponent<Aether::TagComponent>(entity).Tag.c_str()))
+                continue;
+            m_HierarchyFiltered.push_back(i);
+        }
+    }
+
+    ImGui::TextDisabled("%zu / %zu entities", m_HierarchyFiltered.size(), m_HierarchyEntities.size());
+    ImGui::Separator();
+
+    // Only the rows inside the visible scroll region are submitted to ImGui.
+    ImGui::BeginChild("HierarchyList");
+    ImGuiListClipper clipper;
+    clipper.Begin((int)m_HierarchyFiltered.size());
+    while (clipper.Step())
     {
-        // Trong Engine của bạn, Entity chính là ID (entt::entity)
-        DrawEntityNode(entity);
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+        {
+            Aether::Entity entity = m_HierarchyEntities[m_HierarchyFiltered[row]];
+            if (!m_Scene.IsValid(entity)) { ImGui::TextDisabled("<destroyed>"); continue; }
+            DrawEntityNode(entity);
+        }
     }
+    clipper.End();
+    ImGui::EndChild();
 
     if (ImGui::IsMouseDown(0) && ImGui::IsWindowHovered())
     {
@@ -1311,18 +1991,26 @@ void MainGameLayer::DrawHierarchyPanel()
     ImGui::End();
 }
 
+void MainGameLayer::RebuildHierarchyCache()
+{
+    m_HierarchyEntities.clear();
+    for (auto entity : m_Scene.View<Aether::TagComponent>())
+        m_HierarchyEntities.push_back(entity);
+    m_HierarchyDirty = false;
+}
+
 void MainGameLayer::DrawEntityNode(Aether::Entity entity)
 {
     auto& tag = m_Scene.GetComponent<Aether::TagComponent>(entity).Tag;
     
-    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanAvailWidth;
-    bool opened = ImGui::TreeNodeEx((void*)(uint64_t)(uint32_t)entity, flags, tag.c_str());
+    // Leaf rows keep every line the same height, which the list clipper relies on.
+    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen |
+                               ImGuiTreeNodeFlags_SpanAvailWidth;
+    ImGui::TreeNodeEx((void*)(uint64_t)(uint32_t)entity, flags, "%s", tag.c_str());
     
     if (ImGui::IsItemClicked()) {
         // Xử lý khi click vào entity trong danh sách
     }
-
-    if (opened) ImGui::TreePop();
 }
 
 void MainGameLayer::DrawScenePanel()
@@ -1331,6 +2019,90 @@ void MainGameLayer::DrawScenePanel()
     // Thêm các checkbox điều chỉnh môi trường như Skybox, Exposure...
     if (ImGui::CollapsingHeader("Environment")) {
         // Ví dụ: ImGui::DragFloat("Exposure", &m_Exposure, 0.1f);
+        ImGui::SliderInt  ("Fog Mode",    &m_FogMode, 0, 2);
+        ImGui::ColorEdit3 ("Fog Color",   glm::value_ptr(m_FogColor));
+        ImGui::DragFloat  ("Fog Density", &m_FogDensity, 0.001f, 0.0f, 1.0f);
+        ImGui::DragFloat  ("Fog Start",   &m_FogStart,   0.5f,   0.0f, m_FogEnd);
+        ImGui::DragFloat  ("Fog End",     &m_FogEnd,     0.5f,   m_FogStart, 1000.0f);
+        ImGui::DragFloat  ("Shadow Bias", &m_ShadowBias, 0.000001f, 0.0f, 0.01f, "%.6f");
+        ImGui::Text("Uniform sets skipped: %u", m_UniformSetsSkipped);
+    }
+    if (ImGui::CollapsingHeader("Debug")) {
+        ImGui::Checkbox("Flow Field / Chunk Overlay", &m_ShowFlowFieldDebug);
+        ImGui::Checkbox("Flow Cost Heatmap",          &m_ShowFlowFieldHeatmap);
+        ImGui::Text("Overlay: %u primitives, %u vertices",
+                    m_DebugDraw.GetPrimitiveCount(), m_DebugDraw.GetVertexCount());
+        ImGui::Checkbox("Profiler", &m_ShowProfiler);
+        ImGui::Checkbox("Radar",    &m_ShowRadar);
+        // The tick rate is part of a recording; changing it mid-session would desync playback.
+        ImGui::BeginDisabled(m_InputMode != InputMode::Live);
+        ImGui::SliderInt("Sim Tick Rate", &m_SimTickRate, (int)k_MinSimTickRate, (int)k_MaxSimTickRate);
+        ImGui::EndDisabled();
+        ImGui::SliderFloat("Anim LOD Distance", &m_AnimLodDistance, 10.0f, 200.0f);
+        uint32_t animated = 0;
+        for (uint32_t i = 0; i < m_Zombies.Size(); i++)
+            if (m_Zombies.At(i).animPlaying) animated++;
+        ImGui::Text("Animated zombies: %u / %u", animated, m_Zombies.Size());
+        ImGui::Text("Sim tick %llu, %u this frame", (unsigned long long)m_SimTick, m_SimTicksThisFrame);
+        if (m_InputMode == InputMode::Record)
+            ImGui::Text("Recording input: %u frames", m_InputRecorder.GetFrameCount());
+        else if (m_InputMode == InputMode::Replay)
+            ImGui::Text("Replaying input: frame %u / %u",
+                        m_InputPlayback.GetFrameIndex(), m_InputPlayback.GetFrameCount());
+    }
+    if (ImGui::CollapsingHeader("Memory")) {
+        ImGui::Text("Frame arena: %.1f / %.1f KB last frame, peak %.1f KB",
+                    m_FrameArena.GetLastFrameUsed() / 1024.0, m_FrameArena.GetCapacity() / 1024.0,
+                    m_FrameArena.GetPeak() / 1024.0);
+        ImGui::Text("Arena blocks last frame: %zu, grew on %u frames",
+                    m_FrameArena.GetLastFrameBlocks(), m_FrameArena.GetGrowCount());
+
+        if (!AllocTracker::IsActive()) {
+            ImGui::TextDisabled("Build with TLE_TRACK_ALLOCATIONS=1 to count allocations.");
+        } else {
+            ImGui::Checkbox("Allocation Overlay", &m_ShowAllocOverlay);
+            ImGui::Text("Last frame: %llu allocs, %llu frees, %.1f KB live",
+                        (unsigned long long)AllocTracker::GetFrameAllocs(),
+                        (unsigned long long)AllocTracker::GetFrameFrees(),
+                        AllocTracker::GetLiveBytes() / 1024.0);
+            if (ImGui::BeginTable("AllocBudgets", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders))
+            {
+                ImGui::TableSetupColumn("Subsystem");
+                ImGui::TableSetupColumn("Allocs");
+                ImGui::TableSetupColumn("KB / frame");
+                ImGui::TableSetupColumn("Budget KB");
+                ImGui::TableHeadersRow();
+                for (uint32_t i = 0; i < (uint32_t)AllocTag::Count; i++) {
+                    const AllocTag tag   = (AllocTag)i;
+                    const auto&    stats = AllocTracker::GetFrameStats(tag);
+                    const ImVec4   color = AllocTracker::IsOverBudget(tag) ? ImVec4(1.0f, 0.3f, 0.3f, 1.0f)
+                                                                           : ImGui::GetStyleColorVec4(ImGuiCol_Text);
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::TextColored(color, "%s", AllocTracker::GetTagName(tag));
+                    ImGui::TableNextColumn(); ImGui::TextColored(color, "%llu", (unsigned long long)stats.Allocs);
+                    ImGui::TableNextColumn(); ImGui::TextColored(color, "%.2f", stats.Bytes / 1024.0);
+                    ImGui::TableNextColumn(); ImGui::Text("%.0f", AllocTracker::GetBudget(tag) / 1024.0);
+                }
+                ImGui::EndTable();
+            }
+        }
+    }
+    if (ImGui::CollapsingHeader("Audio")) {
+        ImGui::Text("Voices: %u playing, %u stolen", m_Voices.GetActiveVoices(), m_Voices.GetStolenVoices());
+        if (m_CrowdAudio.IsActive())
+            ImGui::Text("Crowd: %u audible, ambience %.2f",
+                        m_CrowdAudio.GetAudibleCount(), m_CrowdAudio.GetAmbienceVolume());
+        else
+            ImGui::TextDisabled("Crowd audio off: %s not found", k_ZombieGroanPath);
+        if (ImGui::Button("Benchmark 1000 emitters"))
+            BenchmarkCrowdAudio(1000);
+    }
+    if (ImGui::CollapsingHeader("Hitscan")) {
+        ImGui::SliderInt  ("Pellets / Shot", &m_PelletsPerShot, 1, 64);
+        ImGui::SliderFloat("Pellet Spread",  &m_PelletSpread,   0.0f, 0.3f);
+        ImGui::Text("Last batch: %u rays in %.4f ms", m_LastShotRays, m_LastShotResolveMs);
+        if (ImGui::Button("Benchmark 64 pellets"))
+            BenchmarkPellets(64);
     }
     ImGui::End();
 }
@@ -5,20 +5,28 @@
 #include <string>
 #include <map>
 #include <utility>
-#include <queue>
+#include <random>
 #include "Aether/Physics/PhysicsSystem.h"
-
-// --- FLOW FIELD ---
-struct FlowCell {
-    int       cost      = 1;
-    int       bestCost  = 999999;
-    glm::vec3 direction = glm::vec3(0.0f);
-};
+#include "VoicePool.h"
+#include "CrowdAudio.h"
+#include "Hitscan.h"
+#include "EntitySparseSet.h"
+#include "DebugDraw.h"
+#include "SpatialGrid.h"
+#include "GameSnapshot.h"
+#include "InputReplay.h"
+#include "Profiler.h"
+#include "AllocTracker.h"
+#include "FrameArena.h"
+#include "FlowField.h"
+#include "ChunkStreaming.h"
+#include <future>
+#include <chrono>
 
 class MainGameLayer : public Aether::Layer
 {
 public:
-    MainGameLayer();
+    MainGameLayer(InputMode inputMode = InputMode::Live, const std::string& inputPath = {});
     virtual ~MainGameLayer() = default;
 
     virtual void Attach()                      override;
@@ -32,6 +40,7 @@ private:
     void DrawRadar();
     void DrawHierarchyPanel();
     void DrawEntityNode(Aether::Entity entity);
+    void RebuildHierarchyCache();
     void DrawScenePanel();
     void DrawLightingPanel();
     bool WorldToScreen(const glm::vec3& worldPos, const glm::mat4& viewProj, ImVec2 displaySize, ImVec2& outScreen);
@@ -48,7 +57,19 @@ private:
 
     Aether::Entity m_SunLight       = Aether::Null_Entity;
 
-    bool m_ShowFlowFieldDebug = false;
+    bool      m_ShowFlowFieldDebug   = false;
+    bool      m_ShowFlowFieldHeatmap = false;
+    bool      m_ShowProfiler         = false;
+    bool      m_ShowAllocOverlay     = false;
+    bool      m_ShowRadar            = true;
+    FrameArena m_FrameArena;             // transient per-frame containers, reset at the end of Update
+    DebugDraw m_DebugDraw;
+
+    // --- Hierarchy Panel ---
+    std::vector<Aether::Entity> m_HierarchyEntities;   // cached TagComponent view
+    std::vector<uint32_t>       m_HierarchyFiltered;   // rows passing the name filter
+    ImGuiTextFilter             m_HierarchyFilter;
+    bool                        m_HierarchyDirty = true; // set whenever the layer creates/destroys entities
 
 
     // --- Player ---
@@ -67,26 +88,97 @@ private:
     float m_MaxHealth = 100.0f;       // Máu tối đa
     float m_DamageCooldown = 1.0f;    // Thời gian chờ giữa các lần bị cắn (để không chết ngay lập tức)
 
+    // --- Fixed-step Simulation ---
+    // Gameplay advances in ticks of 1/m_SimTickRate on these poses; transforms show
+    // a blend of the last two ticks so rendering stays smooth at any frame rate.
+    struct SimPose {
+        glm::vec3 position = glm::vec3(0.0f);
+        glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    };
+    // Everything a tick reads from the outside world, sampled once per frame.
+    struct SimInput {
+        glm::vec3 moveDir   = glm::vec3(0.0f); // camera-relative WASD on the XZ plane, unnormalised
+        float     cameraYaw = 0.0f;
+        bool      reload    = false;
+        bool      respawn   = false;
+    };
+    static constexpr float k_MaxSimBacklog = 0.25f; // drop simulated time beyond this after a hitch
+
+    int          m_SimTickRate       = 30;
+    float        m_SimAccumulator    = 0.0f;
+    double       m_SimTime           = 0.0;  // drives the zombie wobble
+    float        m_SpawnTimer        = 0.0f;
+    uint64_t     m_SimTick           = 0;
+    uint32_t     m_SimTicksThisFrame = 0;
+    uint32_t     m_SimSeed           = 1337;
+    std::mt19937 m_SimRng { 1337u };         // all gameplay randomness, so a run replays exactly
+    SimPose      m_PlayerPose;
+    SimPose      m_PlayerPrevPose;
+
+    SimInput SampleSimInput(uint16_t buttons) const;
+    void     SimulationTick(const SimInput& input, float dt);
+    void     RestoreSimPoses();
+    void     SyncSimPoses();
+    void     InterpolateSimPoses(float alpha);
+
+    // --- Input Record / Replay ---
+    enum ReplayStage : uint32_t {
+        Stage_Input, Stage_Simulation, Stage_Present, Stage_Audio, Stage_Scene
+    };
+    enum ReplayCounter : uint32_t { Counter_SimTicks, Counter_Zombies, Counter_Chunks, Counter_Allocs };
+
+    InputMode                m_InputMode = InputMode::Live;
+    std::string              m_InputPath;
+    bool                     m_SaveOnExit = true;   // recorded/replayed sessions never touch save.dat
+    InputRecorder            m_InputRecorder;
+    InputPlayback            m_InputPlayback;
+    std::vector<InputAction> m_FrameActions;        // actions raised since the last Update
+    uint16_t                 m_FrameButtons = 0;    // InputButton bits for this frame
+    StageTimings             m_StageTimings {
+        { "input", "simulation", "present", "audio", "scene" },
+        { "sim_ticks", "zombies", "chunks", "allocs" } };
+
+    uint16_t SampleButtons() const;
+    bool     RaiseAction(InputActionType type);   // handles it now and records it when recording
+    bool     HandleAction(const InputAction& action);
+    void     FinishReplay();
+
     // --- Zombies ---
     struct ZombieRecord {
-        Aether::UUID animatorID = 0;
-        Aether::UUID bodyID     = 0;
+        Aether::UUID animatorID  = 0;
+        Aether::UUID bodyID      = 0;
+        bool         animPlaying = false; // mirrors the rig state so Play/Pause only fire on transitions
+        SimPose      pose;                // authoritative, as of the last tick
+        SimPose      prevPose;            // the tick before, for interpolation
     };
 
     Aether::RegisteredScene                    m_ZombieSceneData;
-    std::vector<Aether::Entity>                m_ActiveZombies;
-    std::map<Aether::Entity, ZombieRecord>     m_ZombieRegistry;
+    EntitySparseSet<ZombieRecord>              m_Zombies; // dense records, keyed by entity index
     Aether::UUID  m_ZombieRunAnimation = 0;
     float         m_ZombieSpeed        = 4.5f;
+    float         m_AnimLodDistance    = 40.0f; // beyond this, walking zombies hold their pose
     Aether::Entity SpawnZombie(const glm::vec3& position);
+    void           DespawnZombie(uint32_t slot);   // frees its animator, body and entity, then swap-removes it
 
     int maxZombies = 100;
 
     uint32_t m_ZombiesKilled = 0; // Số zom diệt trong lượt này
     uint32_t m_HighScore = 0;      // Kỷ lục lưu lại
 
+    // --- Startup ---
+    std::chrono::steady_clock::time_point m_AttachStart;
+    bool m_SerialLoad = false;   // TLE_SERIAL_LOAD=1 imports the models on the main thread, for comparison
+    bool m_FirstFrame = true;
+
+    // --- Save / Snapshot ---
+    std::future<Snapshot::File> m_PendingLoad;
+    std::future<bool>           m_PendingSave;
+    Snapshot::Data CaptureSnapshot() const;
+    void           SaveSnapshotAsync();
+    void           ApplySnapshot(const Snapshot::File& file);
+
     // --- Flow Field ---
-    std::map<std::pair<int, int>, FlowCell> m_FlowField;
+    FlowField m_FlowField { 40 };   // BFS radius in path cells around the player
     float m_PathGridSize = 1.0f;
     int   m_FlowFieldSubdivisions = 16;
     float m_FlowFieldTimer = 0.0f;
@@ -127,10 +219,11 @@ private:
 
     struct ChunkData {
         Aether::Entity              landEntity = Aether::Null_Entity;
-        std::vector<Aether::Entity> zombies;
+        std::vector<Aether::Entity> zombies; // handles into m_Zombies
         int                         rotation = 0; // 0-3 (multiples of 90)
     };  
     std::map<std::pair<int, int>, ChunkData> m_ActiveChunks;
+    ChunkData& CreateChunk(const std::pair<int, int>& coord, int rotation);
 
     Aether::AssetHandle m_BaseMapMesh;
     std::vector<Aether::AssetHandle> m_BaseMapMaterials;
@@ -153,15 +246,65 @@ private:
     float     m_FogStart   = 10.0f;
     float     m_FogEnd     = 80.0f;
 
+    // --- Shader uniform cache ---
+    // Last values pushed to m_MainShader; unchanged uniforms are not re-sent.
+    struct MainShaderUniforms {
+        float     bias       = 0.0f;
+        int       fogMode    = 0;
+        glm::vec3 fogColor   = glm::vec3(0.0f);
+        float     fogDensity = 0.0f;
+        float     fogStart   = 0.0f;
+        float     fogEnd     = 0.0f;
+    };
+    MainShaderUniforms m_AppliedUniforms;
+    bool     m_UniformsApplied    = false;
+    uint32_t m_UniformSetsSkipped = 0; // redundant uniform sets avoided this frame
+    void ApplyMainShaderUniforms();
+
     Aether::UUID m_GunSoundID;
     Aether::UUID m_GunReloadID;
     Aether::UUID m_ZombieBiteID;
     Aether::UUID m_BgmSoundID;
-    std::vector<Aether::UUID> sources;
+    Aether::UUID m_ZombieGroanID;
+    static constexpr const char* k_ZombieGroanPath = "Assets/audio/zombie_groan.wav";
+    VoicePool    m_Voices { 10 };   // fewer than the voices reserved, so priorities decide who plays
+    CrowdAudio   m_CrowdAudio;
+    std::vector<glm::vec3> m_ZombieEmitters;        // zombie positions, gathered at most once per frame
+    bool                   m_ZombieEmittersValid = false;
+    SpatialGrid            m_ZombieGrid { 8.0f };   // built by DrawRadar, only while the radar is shown
+    const std::vector<glm::vec3>& GatherZombiePositions();
+    float BenchmarkCrowdAudio(uint32_t emitterCount);
+
+    // --- Radar ---
+    struct RadarBin {
+        uint32_t count = 0;
+        float    sumX  = 0.0f;
+        float    sumY  = 0.0f;
+    };
+    static constexpr int  k_RadarBins = 16;
+    std::vector<float>    m_RadarRelX;
+    std::vector<float>    m_RadarRelZ;
+    std::vector<RadarBin> m_RadarBins;
 
     float m_ShootTimer    = 0.0f;
     float m_ShootDuration = 0.3f;
 
+    // --- Shot Queue ---
+    int   m_PelletsPerShot = 1;      // >1 for shotgun-style spreads
+    float m_PelletSpread   = 0.05f;  // radians, only used when m_PelletsPerShot > 1
+    std::vector<ShotRay>                 m_ShotQueue;
+    std::vector<ShotHit>                 m_ShotHits;
+    std::vector<HitscanBVH::Capsule>     m_ZombieCapsules;
+    std::vector<uint32_t>                m_KilledIndices;
+    HitscanBVH                           m_ZombieBVH;
+    uint32_t m_LastShotRays      = 0;
+    float    m_LastShotResolveMs = 0.0f;
+    void  QueueShot(const glm::vec3& origin, const glm::vec3& direction, int pellets, float spread);
+    void  ClipShotRays(std::vector<ShotRay>& rays) const;
+    void  BuildZombieBVH();
+    void  ResolveShots();   // runs inside SimulationTick, against the sim poses
+    float BenchmarkPellets(int pellets);
+
     // hardcode matrix — 0: free, 0.5: slow zone (building edge), 1: solid wall
     static constexpr int   k_ObstacleMapSize = 16;
     static constexpr float k_CapsuleRadius   = 0.35f;
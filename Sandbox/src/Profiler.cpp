@@ -0,0 +1,338 @@
+#include "Profiler.h"
+#include <imgui.h>
+#include <chrono>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <fstream>
+#include <cstdio>
+
+namespace Profiler {
+
+    std::atomic<bool> g_Enabled { false };
+
+    static constexpr uint64_t k_Capacity     = 1u << 15;  // zones per thread before the ring wraps
+    static constexpr uint32_t k_FrameHistory = 4;
+
+    // Ring slot. Its fields are relaxed atomics because a reader may copy a slot while its
+    // owner overwrites it; such copies are dropped afterwards, but must not be a data race.
+    struct Slot {
+        std::atomic<const char*> Name     { nullptr };
+        std::atomic<uint64_t>    StartNs  { 0 };
+        std::atomic<uint64_t>    EndNs    { 0 };
+        std::atomic<uint32_t>    ThreadID { 0 };
+        std::atomic<uint32_t>    Depth    { 0 };
+
+        void Store(const ZoneEvent& e)
+        {
+            Name.store(e.Name, std::memory_order_relaxed);
+            StartNs.store(e.StartNs, std::memory_order_relaxed);
+            EndNs.store(e.EndNs, std::memory_order_relaxed);
+            ThreadID.store(e.ThreadID, std::memory_order_relaxed);
+            Depth.store(e.Depth, std::memory_order_relaxed);
+        }
+
+        ZoneEvent Load() const
+        {
+            return { Name.load(std::memory_order_relaxed),     StartNs.load(std::memory_order_relaxed),
+                     EndNs.load(std::memory_order_relaxed),    ThreadID.load(std::memory_order_relaxed),
+                     Depth.load(std::memory_order_relaxed) };
+        }
+    };
+
+    struct ThreadBuffer {
+        std::unique_ptr<Slot[]>      Events { new Slot[k_Capacity] };
+        std::atomic<uint64_t>        Head   { 0 };     // total zones written; only the owner advances it
+        std::atomic<bool>            InUse  { true };
+        uint32_t                     ThreadID = 0;
+        std::string                  Name;
+    };
+
+    // Buffers outlive their threads so a trace can still be exported after a worker exits;
+    // a new thread takes over a retired buffer instead of growing the list. Before that, the
+    // old thread's zones and name move to the retired list, so they keep their own lane.
+    static std::mutex                                      s_RegistryMutex;
+    static std::vector<std::unique_ptr<ThreadBuffer>>      s_Buffers;
+    static std::vector<ZoneEvent>                          s_RetiredEvents;   // oldest first, at most k_Capacity
+    static std::vector<std::pair<uint32_t, std::string>>   s_RetiredThreads;  // id, name
+    static uint32_t                                        s_NextThreadID = 0;
+
+    struct ThreadSlot {
+        ThreadBuffer* Buffer = nullptr;
+        uint32_t      Depth  = 0;
+        ~ThreadSlot() { if (Buffer) Buffer->InUse.store(false, std::memory_order_release); }
+    };
+    static thread_local ThreadSlot t_Slot;
+
+    static uint64_t s_FrameStarts[k_FrameHistory] = {};
+    static uint64_t s_FrameCount = 0;
+
+    // Called with s_RegistryMutex held, on a buffer whose thread has exited.
+    static void RetireBuffer(ThreadBuffer& buffer)
+    {
+        const uint64_t head   = buffer.Head.load(std::memory_order_acquire);
+        const uint64_t oldest = head > k_Capacity ? head - k_Capacity : 0;
+        if (head == 0) return;
+
+        for (uint64_t i = oldest; i < head; i++)
+            s_RetiredEvents.push_back(buffer.Events[i & (k_Capacity - 1)].Load());
+        if (s_RetiredEvents.size() > k_Capacity)
+            s_RetiredEvents.erase(s_RetiredEvents.begin(), s_RetiredEvents.end() - k_Capacity);
+
+        s_RetiredThreads.push_back({ buffer.ThreadID, buffer.Name });
+        buffer.Head.store(0, std::memory_order_relaxed);
+    }
+
+    static ThreadBuffer& AcquireBuffer()
+    {
+        if (t_Slot.Buffer) return *t_Slot.Buffer;
+
+        std::lock_guard<std::mutex> lock(s_RegistryMutex);
+        ThreadBuffer* buffer = nullptr;
+        for (auto& b : s_Buffers)
+            if (!b->InUse.load(std::memory_order_acquire)) { buffer = b.get(); break; }
+        if (buffer) {
+            RetireBuffer(*buffer);
+        } else {
+            s_Buffers.push_back(std::make_unique<ThreadBuffer>());
+            buffer = s_Buffers.back().get();
+        }
+        buffer->InUse.store(true, std::memory_order_relaxed);
+        buffer->ThreadID = s_NextThreadID++;
+        buffer->Name     = "Thread " + std::to_string(buffer->ThreadID);
+        t_Slot.Buffer    = buffer;
+        return *buffer;
+    }
+
+    void SetEnabled(bool enabled)
+    {
+        g_Enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    uint64_t NowNs()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void SetThreadName(const char* name)
+    {
+        ThreadBuffer& buffer = AcquireBuffer();
+        std::lock_guard<std::mutex> lock(s_RegistryMutex);
+        buffer.Name = name;
+    }
+
+    void MarkFrame()
+    {
+        s_FrameStarts[s_FrameCount % k_FrameHistory] = NowNs();
+        s_FrameCount++;
+    }
+
+    uint32_t PushDepth()
+    {
+        return t_Slot.Depth++;
+    }
+
+    void Record(const char* name, uint64_t startNs, uint32_t depth)
+    {
+        uint64_t      endNs  = NowNs();
+        ThreadBuffer& buffer = AcquireBuffer();
+        uint64_t      head   = buffer.Head.load(std::memory_order_relaxed);
+
+        buffer.Events[head & (k_Capacity - 1)].Store({ name, startNs, endNs, buffer.ThreadID, depth });
+        buffer.Head.store(head + 1, std::memory_order_release);
+        t_Slot.Depth = depth;
+    }
+
+    // Copies every zone that ended at or after fromNs, skipping slots the writer may have
+    // reused meanwhile. Live threads come out newest first.
+    static void CollectSince(uint64_t fromNs, std::vector<ZoneEvent>& out)
+    {
+        std::lock_guard<std::mutex> lock(s_RegistryMutex);
+        for (const ZoneEvent& e : s_RetiredEvents)   // appended per retired thread, so not in end order overall
+            if (e.EndNs >= fromNs) out.push_back(e);
+
+        for (auto& buffer : s_Buffers)
+        {
+            const uint64_t head   = buffer->Head.load(std::memory_order_acquire);
+            const uint64_t oldest = head > k_Capacity ? head - k_Capacity : 0;
+            const size_t   first  = out.size();
+
+            for (uint64_t i = head; i > oldest; i--)
+            {
+                const ZoneEvent e = buffer->Events[(i - 1) & (k_Capacity - 1)].Load();
+                if (e.EndNs < fromNs) break; // zones land in end order, so everything older ended earlier
+                out.push_back(e);
+            }
+
+            // The copies above must finish before Head is re-read. Slot i is shared with
+            // i + k_Capacity, which the writer may be filling once newHead reaches it, so every
+            // index at or below newHead - k_Capacity may be torn.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t newHead = buffer->Head.load(std::memory_order_relaxed);
+            if (newHead >= k_Capacity) {
+                const uint64_t safe = newHead - k_Capacity + 1;
+                size_t keep = first;
+                for (size_t k = first; k < out.size(); k++)
+                    if (head - 1 - (k - first) >= safe) out[keep++] = out[k];
+                out.resize(keep);
+            }
+        }
+    }
+
+    static ImU32 ColorFor(const char* name)
+    {
+        uint32_t h = 2166136261u;
+        for (const char* c = name; *c; c++) h = (h ^ (uint8_t)*c) * 16777619u;
+        return IM_COL32(90 + (h & 0x7F), 90 + ((h >> 8) & 0x7F), 90 + ((h >> 16) & 0x7F), 255);
+    }
+
+    void DrawPanel(bool* open)
+    {
+        if (!ImGui::Begin("Profiler", open)) { ImGui::End(); return; }
+
+        bool enabled = IsEnabled();
+        if (ImGui::Checkbox("Capture", &enabled)) SetEnabled(enabled);
+        ImGui::SameLine();
+        if (ImGui::Button("Export Chrome Trace"))
+            WriteChromeTrace("profile_trace.json");
+
+        if (s_FrameCount < 2) { ImGui::TextUnformatted("Waiting for frames..."); ImGui::End(); return; }
+
+        // Last complete frame.
+        const uint64_t frameStart = s_FrameStarts[(s_FrameCount - 2) % k_FrameHistory];
+        const uint64_t frameEnd   = s_FrameStarts[(s_FrameCount - 1) % k_FrameHistory];
+        const float    frameMs    = (frameEnd - frameStart) / 1e6f;
+        ImGui::Text("Frame: %.3f ms", frameMs);
+
+        static std::vector<ZoneEvent> s_Events;
+        s_Events.clear();
+        CollectSince(frameStart, s_Events);
+        s_Events.erase(std::remove_if(s_Events.begin(), s_Events.end(),
+                           [&](const ZoneEvent& e) { return e.StartNs >= frameEnd; }),
+                       s_Events.end());
+
+        // One lane per thread, one row per nesting depth.
+        std::vector<std::pair<uint32_t, uint32_t>> lanes; // thread id, depth count
+        for (const ZoneEvent& e : s_Events) {
+            auto it = std::find_if(lanes.begin(), lanes.end(), [&](auto& l) { return l.first == e.ThreadID; });
+            if (it == lanes.end()) lanes.push_back({ e.ThreadID, e.Depth + 1 });
+            else                   it->second = std::max(it->second, e.Depth + 1);
+        }
+        std::sort(lanes.begin(), lanes.end());
+
+        const float  rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+        const float  width     = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+        const double nsToPx    = width / (double)std::max<uint64_t>(frameEnd - frameStart, 1);
+        ImDrawList*  drawList  = ImGui::GetWindowDrawList();
+        ImVec2       origin    = ImGui::GetCursorScreenPos();
+        ImVec2       mouse     = ImGui::GetIO().MousePos;
+
+        float laneY = origin.y;
+        for (auto& [threadID, depthCount] : lanes)
+        {
+            for (const ZoneEvent& e : s_Events)
+            {
+                if (e.ThreadID != threadID) continue;
+                float x0 = origin.x + (float)((double)(std::max(e.StartNs, frameStart) - frameStart) * nsToPx);
+                float x1 = origin.x + (float)((double)(std::min(e.EndNs, frameEnd) - frameStart) * nsToPx);
+                float y0 = laneY + e.Depth * rowHeight;
+                x1 = std::max(x1, x0 + 1.0f);
+
+                drawList->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y0 + rowHeight - 1.0f), ColorFor(e.Name));
+                if (x1 - x0 > ImGui::CalcTextSize(e.Name).x + 4.0f)
+                    drawList->AddText(ImVec2(x0 + 2.0f, y0 + 2.0f), IM_COL32(0, 0, 0, 255), e.Name);
+
+                if (mouse.x >= x0 && mouse.x < x1 && mouse.y >= y0 && mouse.y < y0 + rowHeight && ImGui::IsWindowHovered())
+                    ImGui::SetTooltip("%s\n%.3f ms", e.Name, (e.EndNs - e.StartNs) / 1e6f);
+            }
+            laneY += depthCount * rowHeight + 4.0f;
+        }
+        ImGui::Dummy(ImVec2(width, laneY - origin.y));
+
+        // Totals per zone name.
+        struct Total { const char* name; double ms; uint32_t calls; };
+        std::unordered_map<const char*, Total> totals;
+        for (const ZoneEvent& e : s_Events) {
+            Total& t = totals.try_emplace(e.Name, Total{ e.Name, 0.0, 0 }).first->second;
+            t.ms += (e.EndNs - e.StartNs) / 1e6;
+            t.calls++;
+        }
+        std::vector<Total> sorted;
+        sorted.reserve(totals.size());
+        for (auto& [name, total] : totals) sorted.push_back(total);
+        std::sort(sorted.begin(), sorted.end(), [](const Total& a, const Total& b) { return a.ms > b.ms; });
+
+        if (ImGui::BeginTable("ProfilerTotals", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders))
+        {
+            ImGui::TableSetupColumn("Zone");
+            ImGui::TableSetupColumn("ms");
+            ImGui::TableSetupColumn("Calls");
+            ImGui::TableHeadersRow();
+            for (const Total& t : sorted) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(t.name);
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", t.ms);
+                ImGui::TableNextColumn(); ImGui::Text("%u", t.calls);
+            }
+            ImGui::EndTable();
+        }
+
+        ImGui::End();
+    }
+
+    static void WriteJsonString(std::ofstream& out, const char* text)
+    {
+        out << '"';
+        for (const char* c = text; *c; c++) {
+            if (*c == '"' || *c == '\\') out << '\\';
+            out << *c;
+        }
+        out << '"';
+    }
+
+    bool WriteChromeTrace(const std::string& path)
+    {
+        std::vector<ZoneEvent> events;
+        CollectSince(0, events);
+
+        std::vector<std::pair<uint32_t, std::string>> threads;
+        {
+            std::lock_guard<std::mutex> lock(s_RegistryMutex);
+            threads = s_RetiredThreads;
+            for (auto& buffer : s_Buffers) threads.push_back({ buffer->ThreadID, buffer->Name });
+        }
+
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) return false;
+
+        uint64_t origin = UINT64_MAX;
+        for (const ZoneEvent& e : events) origin = std::min(origin, e.StartNs);
+
+        out << "{\"traceEvents\":[\n";
+        bool first = true;
+        for (auto& [id, name] : threads) {
+            out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << id
+                << ",\"args\":{\"name\":";
+            WriteJsonString(out, name.c_str());
+            out << "}}";
+            first = false;
+        }
+
+        char number[64];
+        for (auto it = events.rbegin(); it != events.rend(); ++it) {
+            const ZoneEvent& e = *it;
+            out << (first ? "" : ",\n") << "{\"name\":";
+            WriteJsonString(out, e.Name);
+            std::snprintf(number, sizeof(number), "%.3f", (e.StartNs - origin) / 1e3);
+            out << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << e.ThreadID << ",\"ts\":" << number;
+            std::snprintf(number, sizeof(number), "%.3f", (e.EndNs - e.StartNs) / 1e3);
+            out << ",\"dur\":" << number << '}';
+            first = false;
+        }
+        out << "\n]}\n";
+        return (bool)out;
+    }
+}
@@ -1,13 +1,20 @@
 #include "Aether/Core/EntryPoint.h"
 //#include "TestLayer.h"
 #include "MainGameLayer.h"
+#include <cstdlib>
 //#include "GameLayer.h"
 
 class Sandbox : public Aether::Application {
 public:
     Sandbox() { 
         // PushLayer(new GameLayer());
-        PushLayer(new MainGameLayer());
+        // TLE_RECORD_INPUT=<file> records a session, TLE_REPLAY_INPUT=<file> plays one back for profiling.
+        if (const char* path = std::getenv("TLE_REPLAY_INPUT"))
+            PushLayer(new MainGameLayer(InputMode::Replay, path));
+        else if (const char* path = std::getenv("TLE_RECORD_INPUT"))
+            PushLayer(new MainGameLayer(InputMode::Record, path));
+        else
+            PushLayer(new MainGameLayer());
     }
     ~Sandbox() {}
 };
@@ -0,0 +1,31 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+
+void SpatialGrid::Build(const std::vector<glm::vec3>& points)
+{
+    const uint32_t count = (uint32_t)points.size();
+    m_Points.resize(count);
+    m_Buckets.resize(count);
+    m_Entries.resize(count);
+    m_CellStart.assign(m_TableSize + 1, 0);
+
+    // Count points per bucket...
+    for (uint32_t i = 0; i < count; i++)
+    {
+        m_Points[i]  = glm::vec2(points[i].x, points[i].z);
+        m_Buckets[i] = Hash(CellCoord(points[i].x), CellCoord(points[i].z));
+        m_CellStart[m_Buckets[i] + 1]++;
+    }
+
+    // ...prefix-sum into start offsets...
+    for (uint32_t b = 0; b < m_TableSize; b++)
+        m_CellStart[b + 1] += m_CellStart[b];
+
+    // ...and scatter, using the end of each range as a running cursor.
+    for (uint32_t i = 0; i < count; i++)
+        m_Entries[--m_CellStart[m_Buckets[i] + 1]] = i;
+
+    // The scatter walked each cursor back to its bucket's start, so shift the table down one slot.
+    std::rotate(m_CellStart.begin(), m_CellStart.begin() + 1, m_CellStart.end());
+    m_CellStart[m_TableSize] = count;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+// --- SPATIAL GRID ---
+// Hashed uniform grid over the XZ plane, rebuilt from a point list each frame.
+// Points are bucketed with a counting sort into one flat array. A rebuild
+// reuses the previous frame's storage, and a radius query only visits the
+// cells that overlap the query circle.
+class SpatialGrid
+{
+public:
+    explicit SpatialGrid(float cellSize = 8.0f, uint32_t tableBits = 12)
+        : m_CellSize(cellSize), m_InvCellSize(1.0f / cellSize), m_TableSize(1u << tableBits) {}
+
+    void Build(const std::vector<glm::vec3>& points);
+
+    // fn(index, dx, dz) for every point within radius of center; dx/dz are relative to center.
+    template<typename Fn>
+    void QueryRadius(const glm::vec3& center, float radius, Fn&& fn) const
+    {
+        if (m_Points.empty()) return;
+
+        const float radiusSq = radius * radius;
+        const int   minX = CellCoord(center.x - radius), maxX = CellCoord(center.x + radius);
+        const int   minZ = CellCoord(center.z - radius), maxZ = CellCoord(center.z + radius);
+
+        for (int cx = minX; cx <= maxX; cx++)
+        {
+            for (int cz = minZ; cz <= maxZ; cz++)
+            {
+                uint32_t bucket = Hash(cx, cz);
+                for (uint32_t e = m_CellStart[bucket]; e < m_CellStart[bucket + 1]; e++)
+                {
+                    uint32_t         i = m_Entries[e];
+                    const glm::vec2& p = m_Points[i];
+                    // Different cells can share a bucket; only count each point from its own cell.
+                    if (CellCoord(p.x) != cx || CellCoord(p.y) != cz) continue;
+
+                    float dx = p.x - center.x;
+                    float dz = p.y - center.z;
+                    if (dx * dx + dz * dz <= radiusSq) fn(i, dx, dz);
+                }
+            }
+        }
+    }
+
+    uint32_t Size() const { return (uint32_t)m_Points.size(); }
+
+private:
+    int CellCoord(float v) const { return (int)std::floor(v * m_InvCellSize); }
+
+    uint32_t Hash(int x, int z) const
+    {
+        return ((uint32_t)x * 73856093u ^ (uint32_t)z * 19349663u) & (m_TableSize - 1);
+    }
+
+private:
+    float    m_CellSize;
+    float    m_InvCellSize;
+    uint32_t m_TableSize;
+
+    std::vector<glm::vec2> m_Points;     // xz of every point
+    std::vector<uint32_t>  m_Buckets;    // bucket of every point
+    std::vector<uint32_t>  m_CellStart;  // m_TableSize + 1 prefix offsets into m_Entries
+    std::vector<uint32_t>  m_Entries;    // point indices grouped by bucket
+};
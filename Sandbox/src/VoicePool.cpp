@@ -0,0 +1,138 @@
+#include "VoicePool.h"
+
+void VoicePool::Reserve(Aether::UUID soundID, uint32_t voiceCount, int priority, Aether::AudioType type)
+{
+    for (uint32_t i = 0; i < voiceCount; i++)
+    {
+        Voice voice;
+        voice.soundID  = soundID;
+        voice.priority = priority;
+        Aether::AudioSystem::CreateSource(voice.sourceID, soundID, type);
+        m_Voices.push_back(voice);
+    }
+}
+
+bool VoicePool::PlayOneShot(Aether::UUID soundID, float volume)
+{
+    Voice* voice = Acquire(soundID);
+    if (!voice) return false;
+    Start(*voice, volume);
+    return true;
+}
+
+bool VoicePool::PlayOneShotAt(Aether::UUID soundID, const glm::vec3& position, float volume)
+{
+    Voice* voice = Acquire(soundID);
+    if (!voice) return false;
+
+    Aether::AudioSystem::SetPosition(voice->sourceID, position);
+    Start(*voice, volume);
+    return true;
+}
+
+void VoicePool::Update()
+{
+    // Bounded by the pool size, not by how many sounds were ever played.
+    for (auto& voice : m_Voices)
+    {
+        if (voice.active && !Aether::AudioSystem::IsActive(voice.sourceID))
+        {
+            voice.active = false;
+            m_ActiveCount--;
+        }
+    }
+}
+
+void VoicePool::Release(Aether::UUID soundID)
+{
+    for (auto it = m_Voices.begin(); it != m_Voices.end(); )
+    {
+        if (it->soundID != soundID) { ++it; continue; }
+        Stop(*it);
+        Aether::AudioSystem::DestroySource(it->sourceID);
+        it = m_Voices.erase(it);
+    }
+}
+
+void VoicePool::Clear()
+{
+    for (auto& voice : m_Voices)
+    {
+        Stop(voice);
+        Aether::AudioSystem::DestroySource(voice.sourceID);
+    }
+    m_Voices.clear();
+    m_ActiveCount = 0;
+}
+
+VoicePool::Voice* VoicePool::Acquire(Aether::UUID soundID)
+{
+    Voice* voice = FindFreeVoice(soundID);
+
+    if (!voice)
+    {
+        // Every voice of this sound is busy (or none was reserved): restart the oldest one.
+        voice = FindOldestVoice(soundID);
+        if (!voice) { AE_WARN("VoicePool: no voices reserved for sound {0}", (uint64_t)soundID); return nullptr; }
+        Stop(*voice);
+        m_StolenCount++;
+    }
+    else if (m_ActiveCount >= m_MaxActive)
+    {
+        Voice* victim = FindStealCandidate(voice->priority);
+        if (!victim) return nullptr; // everything playing outranks this sound
+        Stop(*victim);
+        m_StolenCount++;
+    }
+    return voice;
+}
+
+VoicePool::Voice* VoicePool::FindFreeVoice(Aether::UUID soundID)
+{
+    for (auto& voice : m_Voices)
+        if (voice.soundID == soundID && !voice.active) return &voice;
+    return nullptr;
+}
+
+VoicePool::Voice* VoicePool::FindOldestVoice(Aether::UUID soundID)
+{
+    Voice* oldest = nullptr;
+    for (auto& voice : m_Voices)
+    {
+        if (voice.soundID != soundID) continue;
+        if (!oldest || voice.startedAt < oldest->startedAt) oldest = &voice;
+    }
+    return oldest;
+}
+
+VoicePool::Voice* VoicePool::FindStealCandidate(int maxPriority)
+{
+    Voice* best = nullptr;
+    for (auto& voice : m_Voices)
+    {
+        if (!voice.active || voice.priority > maxPriority) continue;
+        if (!best || voice.priority < best->priority ||
+            (voice.priority == best->priority && voice.startedAt < best->startedAt))
+            best = &voice;
+    }
+    return best;
+}
+
+void VoicePool::Start(Voice& voice, float volume)
+{
+    Aether::AudioSystem::SetVolume(voice.sourceID, volume);
+    Aether::AudioSystem::Play(voice.sourceID);
+    voice.active    = true;
+    voice.startedAt = ++m_PlayCounter;
+    m_ActiveCount++;
+}
+
+void VoicePool::Stop(Voice& voice)
+{
+    Aether::AudioSystem::Stop(voice.sourceID);
+    if (voice.active)
+    {
+        voice.active = false;
+        m_ActiveCount--;
+    }
+}
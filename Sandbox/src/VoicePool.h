@@ -0,0 +1,56 @@
+#pragma once
+#include <Aether.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+// --- VOICE POOL ---
+// Fixed set of audio sources for short one-shot effects. Each reserved sound
+// gets its own voices, created once and re-triggered on every play. The number
+// of voices playing at once is capped below the number reserved; when the cap
+// is hit, the lowest-priority and then oldest voice is stopped so the new
+// sound can play. Sounds reserved as Audio3D are placed at the emitter when
+// played and attenuated by the engine relative to the listener.
+class VoicePool
+{
+public:
+    explicit VoicePool(uint32_t maxActiveVoices = 16) : m_MaxActive(maxActiveVoices) {}
+    ~VoicePool() { Clear(); }
+
+    VoicePool(const VoicePool&) = delete;
+    VoicePool& operator=(const VoicePool&) = delete;
+
+    void Reserve(Aether::UUID soundID, uint32_t voiceCount, int priority = 0,
+                 Aether::AudioType type = Aether::AudioType::Audio2D);
+    void Release(Aether::UUID soundID);   // stops and destroys the voices of one sound
+    bool PlayOneShot(Aether::UUID soundID, float volume = 1.0f);
+    bool PlayOneShotAt(Aether::UUID soundID, const glm::vec3& position, float volume = 1.0f);   // Audio3D voices
+    void Update();
+    void Clear();                         // stops and destroys every voice
+
+    uint32_t GetActiveVoices() const { return m_ActiveCount; }
+    uint32_t GetStolenVoices() const { return m_StolenCount; }
+
+private:
+    struct Voice {
+        Aether::UUID sourceID  = 0;
+        Aether::UUID soundID   = 0;
+        int          priority  = 0;
+        uint64_t     startedAt = 0; // play sequence number, lower = older
+        bool         active    = false;
+    };
+
+    Voice* Acquire(Aether::UUID soundID);   // a free voice, or one stolen for it; nullptr if none
+    Voice* FindFreeVoice(Aether::UUID soundID);
+    Voice* FindOldestVoice(Aether::UUID soundID);
+    Voice* FindStealCandidate(int maxPriority);
+    void   Start(Voice& voice, float volume);
+    void   Stop(Voice& voice);
+
+private:
+    std::vector<Voice> m_Voices;
+    uint32_t m_MaxActive   = 16;
+    uint32_t m_ActiveCount = 0;
+    uint32_t m_StolenCount = 0;
+    uint64_t m_PlayCounter = 0;
+};
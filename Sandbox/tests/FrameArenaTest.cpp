@@ -0,0 +1,127 @@
+// Frame arena test: runs 1000 frames of the arena-backed bookkeeping that
+// MainGameLayer::Update does (chunk keep/unload lists from ChunkStreaming and
+// the FlowField rebuild) and uses AllocTracker to check that, once the arena
+// has grown to the largest frame, no frame touches the heap. The tracker has
+// to be on, which it is by default unless NDEBUG is set.
+#include "FrameArena.h"
+#include "AllocTracker.h"
+#include "ChunkStreaming.h"
+#include "FlowField.h"
+#include <algorithm>
+#include <map>
+#include <cstdio>
+
+static int s_Failures = 0;
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond);     \
+            s_Failures++;                                                     \
+        }                                                                     \
+    } while (0)
+
+static constexpr int k_Frames       = 1000;
+static constexpr int k_Period       = 60;         // the workload below repeats every k_Period frames
+static constexpr int k_WarmupFrames = k_Period;   // one full cycle, so the largest frame has been seen
+static constexpr int k_ActiveRadius = 9;          // chunks loaded before the loop
+
+// Walls every 9th column with a gap every 5th row, like a maze of fences.
+static int ObstacleCost(int x, int z)
+{
+    const int mx = ((x % 9) + 9) % 9;
+    const int mz = ((z % 5) + 5) % 5;
+    return (mx == 0 && mz != 0) ? FlowField::k_Blocked : 1;
+}
+
+static void TestFlowField()
+{
+    FrameArena arena;
+    FlowField  field(10);
+
+    field.Build(3, -2, arena, [](int, int) { return 1; });
+    const FlowCell* target = field.Find(3, -2);
+    CHECK(target && target->bestCost == 0);
+    CHECK(field.Find(3 + 12, -2) == nullptr);     // radius + 1 is the last ring kept
+    CHECK(field.Find(3 + 11, -2) != nullptr);
+    CHECK(field.Find(4, -2)->bestCost == 10);
+    CHECK(field.Find(4, -1)->bestCost == 14);
+    CHECK(field.Find(6, -2)->direction.x < -0.99f);   // straight back towards the target
+
+    // A wall at x = 5 except for a gap at z = 0: cells behind it route through the gap.
+    field.Build(3, 0, arena, [](int x, int z) { return (x == 5 && z != 0) ? FlowField::k_Blocked : 1; });
+    CHECK(field.Find(5, 3)->bestCost == FlowField::k_Unreached);
+    CHECK(field.Find(6, 0)->bestCost == 30);
+    CHECK(field.Find(6, 3)->bestCost > field.Find(2, 3)->bestCost);
+    CHECK(field.Find(6, 3)->direction.z < 0.0f);
+}
+
+static void TestNoHeapAfterWarmup()
+{
+    CHECK(AllocTracker::IsActive());
+
+    FrameArena arena(4 * 1024);   // small on purpose so the first frames have to grow
+    FlowField  field(40);
+
+    std::map<ChunkCoord, int> activeChunks;
+    for (int x = -k_ActiveRadius; x <= k_ActiveRadius; x++)
+        for (int z = -k_ActiveRadius; z <= k_ActiveRadius; z++)
+            activeChunks[{ x, z }] = 0;
+
+    uint64_t lateAllocs = 0;
+    size_t   maxBlocks  = 0;
+    uint32_t growCount  = 0;
+
+    for (int frame = 0; frame < k_Frames; frame++) {
+        // Chunk bookkeeping as in MainGameLayer::UpdateMapChunks.
+        const int centerX        = (frame / 20) % 3 - 1;
+        const int renderDistance = 5 + frame % 3;
+        const int diameter       = 2 * renderDistance + 1;
+        FrameVector<ChunkCoord> chunksToKeep(arena);
+        FrameVector<ChunkCoord> chunksToUnload(arena);
+        GatherChunksInRange(centerX, 0, renderDistance, chunksToKeep);
+        GatherChunksOutOfRange(activeChunks, chunksToKeep, chunksToUnload);
+
+        CHECK(chunksToKeep.size() == (size_t)(diameter * diameter));
+        CHECK(std::is_sorted(chunksToKeep.begin(), chunksToKeep.end()));
+        CHECK(IsChunkKept(chunksToKeep, { centerX, 0 }));
+        CHECK(chunksToUnload.size() == activeChunks.size() - chunksToKeep.size());
+
+        // Flow-field rebuild as in MainGameLayer::UpdateFlowField.
+        const int targetX = frame % 20 - 10;
+        field.Build(targetX, 2, arena, ObstacleCost);
+        CHECK(field.Find(targetX, 2)->bestCost == 0);
+
+        const size_t used = arena.GetUsed();
+        arena.Reset();
+        AllocTracker::EndFrame();
+
+        CHECK(arena.GetLastFrameUsed() == used);
+        CHECK(arena.GetUsed() == 0);
+        CHECK(arena.GetPeak() >= used);
+        CHECK(arena.GetCapacity() >= arena.GetPeak());
+        maxBlocks = std::max(maxBlocks, arena.GetLastFrameBlocks());
+
+        if (frame == k_WarmupFrames - 1) growCount = arena.GetGrowCount();
+        if (frame >= k_WarmupFrames) {
+            lateAllocs += AllocTracker::GetFrameAllocs();
+            CHECK(arena.GetLastFrameBlocks() == 1);
+        }
+    }
+
+    if (lateAllocs != 0)
+        std::printf("%llu heap allocations after warmup\n", (unsigned long long)lateAllocs);
+    CHECK(lateAllocs == 0);
+    CHECK(maxBlocks > 1);
+    CHECK(arena.GetGrowCount() > 0);
+    CHECK(arena.GetGrowCount() == growCount);
+}
+
+int main()
+{
+    TestFlowField();
+    TestNoHeapAfterWarmup();
+
+    if (s_Failures == 0) std::printf("FrameArenaTest: all checks passed\n");
+    return s_Failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+// Round-trip test for GameSnapshot: writes a crowd-sized snapshot, maps it
+// back and checks the header, the TOC, and every section byte for byte. Also
+// checks that legacy 8-byte saves and damaged files are handled.
+#include "GameSnapshot.h"
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+
+static int s_Failures = 0;
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond);     \
+            s_Failures++;                                                     \
+        }                                                                     \
+    } while (0)
+
+static Snapshot::Data MakeData(uint32_t zombieCount)
+{
+    Snapshot::Data data;
+    data.MetaInfo = { 4242, 17, { 0, 0 } };
+
+    auto& p = data.PlayerState;
+    p.Position[0] = 1.5f; p.Position[1] = -3.0f; p.Position[2] = 12.25f;
+    p.Rotation[0] = 1.0f;
+    p.Health = 70.0f; p.Ammo = 12; p.Reloading = 1; p.ReloadTimer = 0.75f;
+    p.CameraYaw = 0.5f; p.CameraPitch = -0.25f; p.CameraDistance = 8.0f;
+
+    for (int32_t x = -5; x <= 5; x++)
+        for (int32_t z = -5; z <= 5; z++)
+            data.Chunks.push_back({ x, z, (x * 7 + z) & 3, 0 });
+
+    data.Zombies.resize(zombieCount);
+    for (uint32_t i = 0; i < zombieCount; i++) {
+        Snapshot::Zombie& zombie = data.Zombies[i];
+        std::memset(&zombie, 0, sizeof(zombie));
+        zombie.Position[0]  = (float)i * 0.5f;
+        zombie.Position[2]  = -(float)i;
+        zombie.Rotation[0]  = 1.0f;
+        zombie.Rotation[2]  = (float)(i % 360);
+        zombie.ChunkX       = (int32_t)(i % 11) - 5;
+        zombie.ChunkZ       = (int32_t)(i / 11 % 11) - 5;
+        zombie.OwnedByChunk = i % 3 != 0;
+    }
+    return data;
+}
+
+template<typename T>
+static void CheckSection(const Snapshot::File& file, uint32_t tag, const T* expected, uint64_t expectedCount)
+{
+    uint64_t count = 0;
+    const T* records = file.Get<T>(tag, count);
+    CHECK(records != nullptr);
+    CHECK(count == expectedCount);
+    if (!records || count != expectedCount) return;
+
+    CHECK(reinterpret_cast<uintptr_t>(records) % 16 == 0);
+    CHECK(std::memcmp(records, expected, sizeof(T) * count) == 0);
+}
+
+static void TestRoundTrip(const std::string& path)
+{
+    const Snapshot::Data data = MakeData(10000);
+    CHECK(Snapshot::Write(path, data));
+    CHECK(!std::filesystem::exists(path + ".tmp"));
+
+    Snapshot::File file;
+    CHECK(file.Open(path));
+    CHECK(file.IsOpen());
+    CHECK(!file.IsLegacy());
+    if (!file.IsOpen()) return;
+
+    // Header and TOC, read straight from the file bytes.
+    std::ifstream in(path, std::ios::binary);
+    Snapshot::Header header {};
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    CHECK(header.Magic == Snapshot::k_Magic);
+    CHECK(header.Version == Snapshot::k_Version);
+    CHECK(header.SectionCount == 4);
+
+    std::vector<Snapshot::TocEntry> toc(header.SectionCount);
+    in.read(reinterpret_cast<char*>(toc.data()), (std::streamsize)(toc.size() * sizeof(Snapshot::TocEntry)));
+    uint64_t previousEnd = sizeof(Snapshot::Header) + toc.size() * sizeof(Snapshot::TocEntry);
+    for (const Snapshot::TocEntry& entry : toc) {
+        CHECK(entry.Offset % 16 == 0);
+        CHECK(entry.Offset >= previousEnd);
+        CHECK(entry.Offset + entry.Stride * entry.Count <= file.Size());
+        previousEnd = entry.Offset + entry.Stride * entry.Count;
+    }
+    CHECK(file.Size() % 16 == 0);
+
+    CheckSection(file, Snapshot::k_TagMeta,    &data.MetaInfo,     1);
+    CheckSection(file, Snapshot::k_TagPlayer,  &data.PlayerState,  1);
+    CheckSection(file, Snapshot::k_TagChunks,  data.Chunks.data(),  data.Chunks.size());
+    CheckSection(file, Snapshot::k_TagZombies, data.Zombies.data(), data.Zombies.size());
+
+    // Wrong stride and unknown tags are refused rather than misread.
+    uint64_t count = 1;
+    CHECK(file.Get<Snapshot::Chunk>(Snapshot::k_TagZombies, count) == nullptr && count == 0);
+    CHECK(file.Get<Snapshot::Chunk>(Snapshot::MakeTag('N', 'O', 'P', 'E'), count) == nullptr);
+
+    // Moving the mapping keeps it valid in the new owner only.
+    Snapshot::File moved = std::move(file);
+    CHECK(!file.IsOpen());
+    CHECK(moved.IsOpen());
+    CheckSection(moved, Snapshot::k_TagMeta, &data.MetaInfo, 1);
+}
+
+static void TestLegacy(const std::string& path)
+{
+    const uint32_t legacy[2] = { 99, 7 };
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(legacy), sizeof(legacy));
+    }
+
+    Snapshot::File file;
+    CHECK(file.Open(path));
+    CHECK(file.IsLegacy());
+
+    uint32_t highScore = 0, killed = 0;
+    CHECK(file.ReadLegacy(highScore, killed));
+    CHECK(highScore == 99);
+    CHECK(killed == 7);
+
+    uint64_t count = 0;
+    CHECK(file.Get<Snapshot::Meta>(Snapshot::k_TagMeta, count) == nullptr);
+}
+
+static void TestRejectsDamagedFiles(const std::string& path)
+{
+    CHECK(Snapshot::Write(path, MakeData(100)));
+    std::vector<char> bytes(std::filesystem::file_size(path));
+    {
+        std::ifstream in(path, std::ios::binary);
+        in.read(bytes.data(), (std::streamsize)bytes.size());
+    }
+
+    auto expectRejected = [&](std::vector<char> damaged) {
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(damaged.data(), (std::streamsize)damaged.size());
+        }
+        Snapshot::File file;
+        CHECK(!file.Open(path));
+        CHECK(!file.IsOpen());
+    };
+
+    std::vector<char> badMagic = bytes;
+    badMagic[0] ^= 0x5A;
+    expectRejected(badMagic);
+
+    std::vector<char> badVersion = bytes;
+    reinterpret_cast<Snapshot::Header*>(badVersion.data())->Version = Snapshot::k_Version + 1;
+    expectRejected(badVersion);
+
+    std::vector<char> truncated(bytes.begin(), bytes.begin() + (std::ptrdiff_t)(bytes.size() / 2));
+    expectRejected(truncated);
+
+    std::vector<char> misaligned = bytes;
+    reinterpret_cast<Snapshot::TocEntry*>(misaligned.data() + sizeof(Snapshot::Header))->Offset += 4;
+    expectRejected(misaligned);
+
+    expectRejected({});
+}
+
+int main()
+{
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string path = (dir / "tle_snapshot_test.dat").string();
+
+    TestRoundTrip(path);
+    TestLegacy(path);
+    TestRejectsDamagedFiles(path);
+    std::filesystem::remove(path);
+
+    if (s_Failures == 0) std::printf("SnapshotRoundTripTest: all checks passed\n");
+    return s_Failures == 0 ? 0 : 1;
+}